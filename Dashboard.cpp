@@ -0,0 +1,112 @@
+#include "Dashboard.hpp"
+#include "TuringMachine.hpp"
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+
+static qint64 const restartDelay = 3000000000;
+static qint64 const frameRateWindow = 1000000000;
+
+Dashboard::Dashboard(int count, QWidget * parent)
+: QWidget(parent)
+, started(false)
+{
+    std::vector<std::string> names = machineNames();
+    std::vector<std::string> workloads = workloadNames();
+    std::uniform_int_distribution<int> tapeLen(20, 200);
+    std::vector<int> lengths;
+    for (int i = 0; i < count; ++i) {
+        std::string const & name = names[i % names.size()];
+        std::string const & workload = workloads[i / names.size() % workloads.size()];
+        instances.push_back(Instance{ name, workload, (unsigned)rng(), nullptr, 0, QString() });
+        lengths.push_back(tapeLen(rng));
+    }
+    // Seeding rng per instance would repeat the draws above, so they come first
+    for (int i = 0; i < count; ++i) {
+        restart(instances[i], lengths[i]);
+        instances[i].sim->setRate(8.);
+    }
+    time.start();
+}
+
+void Dashboard::restart(Instance & instance, int tapeLen)
+{
+    rng.seed(instance.seed);
+    if (instance.sim) {
+        instance.sim->reset(tapeLen);
+    }
+    else {
+        Workload workload = UNIFORM;
+        parseWorkload(instance.workload, workload);
+        instance.sim.reset(new Simulation(createMachine(instance.name, workload), tapeLen));
+    }
+    bool sorter = instance.name != "sieve";
+    instance.caption = QString("%1%2 #%3").arg(QString::fromStdString(instance.name))
+                                          .arg(sorter ? QString(" ") + QString::fromStdString(instance.workload) : QString())
+                                          .arg(instance.seed);
+}
+
+QSize Dashboard::sizeHint() const
+{
+    return QSize(1280, 720);
+}
+
+void Dashboard::setRate(int milliLogRate)
+{
+    for (Instance & instance : instances) {
+        instance.sim->setRate(TuringMachine::stepsPerSecond(milliLogRate));
+    }
+}
+
+void Dashboard::paintEvent(QPaintEvent * event)
+{
+    (void)event;
+    qint64 curtime = time.nsecsElapsed();
+    if (!started) {
+        oldtime = curtime;
+        frameWindowStart = curtime;
+        framesInWindow = 0;
+        started = true;
+    }
+    qint64 elapsed = curtime - oldtime;
+    oldtime = curtime;
+    if (curtime - frameWindowStart >= frameRateWindow) {
+        emit frameRateChanged(framesInWindow * 1e9 / (curtime - frameWindowStart));
+        frameWindowStart = curtime;
+        framesInWindow = 0;
+    }
+    ++framesInWindow;
+
+    int count = std::max((int)instances.size(), 1);
+    int cols = (int)ceil(sqrt(count * qreal(width()) / std::max(height(), 1)));
+    cols = std::min(std::max(cols, 1), count);
+    int rows = (count + cols - 1) / cols;
+    int cellWidth = width() / cols;
+    int cellHeight = height() / rows;
+    int dimension = std::min(cellWidth, cellHeight);
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    for (int i = 0; i < (int)instances.size(); ++i) {
+        Instance & instance = instances[i];
+        if (!instance.sim->halted()) {
+            // The instances share one frame's worth of stepping time
+            instance.sim->advance(elapsed, Simulation::frameBudget / count);
+        }
+        else if ((instance.haltedFor += elapsed) >= restartDelay) {
+            ++instance.seed;
+            restart(instance, instance.sim->tapeLength());
+            instance.haltedFor = 0;
+        }
+
+        painter.save();
+        painter.translate(i % cols * cellWidth + (cellWidth - dimension) / 2,
+                          i / cols * cellHeight + (cellHeight - dimension) / 2);
+        instance.sim->render(painter, dimension, false);
+        painter.drawText(0, 0, dimension, dimension, Qt::AlignLeft | Qt::AlignTop,
+                         instance.caption);
+        painter.restore();
+    }
+
+    update();
+}
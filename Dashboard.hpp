@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Simulation.hpp"
+#include <QElapsedTimer>
+#include <QWidget>
+#include <memory>
+#include <string>
+#include <vector>
+
+// A grid of independent simulations sharing one clock and one paint pass.
+// Instances cycle through the machines and, for the sorters, the workloads,
+// each with a seed of its own. Halted instances restart with a fresh tape,
+// from the next seed, after a short pause.
+class Dashboard : public QWidget
+{
+    Q_OBJECT
+
+public:
+    Dashboard(int count, QWidget * parent = 0);
+    QSize sizeHint() const Q_DECL_OVERRIDE;
+
+public slots:
+    // Same scale as TuringMachine::setRate, without pausing
+    void setRate(int milliLogRate);
+
+signals:
+    // Emitted about once a second with the paint rate over that second
+    void frameRateChanged(double framesPerSecond);
+
+protected:
+    void paintEvent(QPaintEvent * event) Q_DECL_OVERRIDE;
+
+private:
+    struct Instance {
+        std::string name;
+        std::string workload;
+        // Seeds rng for the instance's tapes; each restart takes the next one
+        unsigned seed;
+        std::unique_ptr<Simulation> sim;
+        qint64 haltedFor;
+        QString caption;
+    };
+    void restart(Instance & instance, int tapeLen);
+    std::vector<Instance> instances;
+
+    QElapsedTimer time;
+    bool started;
+    qint64 oldtime;
+    qint64 frameWindowStart;
+    int framesInWindow;
+};
@@ -0,0 +1,39 @@
+#include "DashboardWidget.hpp"
+#include "TuringMachine.hpp"
+#include <cstdio>
+
+DashboardWidget::DashboardWidget(int count, QWidget * parent)
+: QWidget(parent)
+, count(count)
+, printFrameRate(false)
+{
+    layout = new QGridLayout(this);
+    dashboard = new Dashboard(count, this);
+    slider = new QSlider(Qt::Vertical, this);
+    // Starting value matches the 8 steps/s the instances start at
+    slider->setRange(1, TuringMachine::rateUnlimited);
+    slider->setValue(3001);
+    frameRateLabel = new QLabel(this);
+    layout->addWidget(dashboard, 0, 0, 1, 1);
+    layout->addWidget(slider, 0, 1, 1, 1);
+    layout->addWidget(frameRateLabel, 1, 0, 1, 2);
+    layout->setColumnStretch(0, 1);
+    layout->setRowStretch(0, 1);
+    setLayout(layout);
+    QObject::connect(slider, SIGNAL(valueChanged(int)), dashboard, SLOT(setRate(int)));
+    QObject::connect(dashboard, SIGNAL(frameRateChanged(double)), this, SLOT(showFrameRate(double)));
+}
+
+void DashboardWidget::setPrintFrameRate(bool print)
+{
+    printFrameRate = print;
+}
+
+void DashboardWidget::showFrameRate(double framesPerSecond)
+{
+    frameRateLabel->setText(QString("%1 fps, %2 machines").arg(framesPerSecond, 0, 'f', 1).arg(count));
+    if (printFrameRate) {
+        printf("%.1f fps, %d machines\n", framesPerSecond, count);
+        fflush(stdout);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Dashboard.hpp"
+#include <QGridLayout>
+#include <QLabel>
+#include <QSlider>
+#include <QWidget>
+
+// The dashboard with a speed slider shared by all its instances, and a
+// readout of how fast it repaints.
+class DashboardWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    DashboardWidget(int count, QWidget * parent = 0);
+    // Also print each frame rate reading to stdout, for scripted measurements
+    void setPrintFrameRate(bool print);
+
+public slots:
+    void showFrameRate(double framesPerSecond);
+
+private:
+    QGridLayout * layout;
+    Dashboard * dashboard;
+    QSlider * slider;
+    QLabel * frameRateLabel;
+    int count;
+    bool printFrameRate;
+};
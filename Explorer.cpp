@@ -0,0 +1,359 @@
+#include "Explorer.hpp"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <utility>
+
+static size_t const segmentSize = 1 << 14;
+static size_t const batchSize = 1 << 16;
+static size_t const initialTableSize = 1 << 10;
+static size_t const maxFrontierMemory = size_t(1) << 20;
+
+static uint64_t mix(uint64_t x)
+{
+    // splitmix64 finaliser
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+static uint64_t zobrist(int cell, unsigned char symbol)
+{
+    return mix(uint64_t(cell) << 8 | symbol);
+}
+
+struct MarkerSearch : public NondeterministicMachine
+{
+    enum State { WALK, FOUND };
+    enum Symbol { BLANK, MARKED, MARKER };
+
+    virtual int initialState() const
+    {
+        return WALK;
+    }
+
+    virtual void reset(std::vector<unsigned char> & tape) const
+    {
+        std::fill(tape.begin(), tape.end(), (unsigned char)BLANK);
+        tape[tape.size() / 2] = MARKER;
+    }
+
+    virtual void transitions(int state, unsigned char symbol, std::vector<NondeterministicTransition> & out) const
+    {
+        if (state == FOUND)
+            return;
+        if (symbol == MARKER) {
+            out.push_back(NondeterministicTransition{ MARKER, LEFT, FOUND });
+            return;
+        }
+        out.push_back(NondeterministicTransition{ MARKED, LEFT, WALK });
+        out.push_back(NondeterministicTransition{ MARKED, RIGHT, WALK });
+    }
+
+    virtual bool accepting(int state) const
+    {
+        return state == FOUND;
+    }
+};
+
+std::unique_ptr<NondeterministicMachine> createMarkerSearch()
+{
+    return std::unique_ptr<MarkerSearch>(new MarkerSearch());
+}
+
+SpillQueue::SpillQueue(size_t memoryLimit)
+: memoryLimit(memoryLimit)
+, file(nullptr)
+, onDisk(0)
+, readOffset(0)
+, writeOffset(0)
+, spilledTotal(0)
+{
+}
+
+SpillQueue::~SpillQueue()
+{
+    if (file)
+        fclose(file);
+}
+
+void SpillQueue::push(uint32_t id)
+{
+    if (memory.size() < memoryLimit) {
+        memory.push_back(id);
+        return;
+    }
+    writeBuffer.push_back(id);
+    if (writeBuffer.size() == segmentSize)
+        flush();
+}
+
+void SpillQueue::flush()
+{
+    if (writeBuffer.empty())
+        return;
+    if (!file)
+        file = tmpfile();
+    if (file) {
+        fseek(file, writeOffset, SEEK_SET);
+        writeOffset += (long)(fwrite(writeBuffer.data(), sizeof(uint32_t), writeBuffer.size(), file) * sizeof(uint32_t));
+        onDisk += writeBuffer.size();
+        spilledTotal += writeBuffer.size();
+        writeBuffer.clear();
+    }
+    else {
+        // No temporary file to be had; keep everything in memory instead.
+        memory.insert(memory.end(), writeBuffer.begin(), writeBuffer.end());
+        writeBuffer.clear();
+    }
+}
+
+bool SpillQueue::pop(size_t n, std::vector<uint32_t> & out)
+{
+    // Fill the batch across memory and disk alike, so how much spilled
+    // never changes which ids are expanded together.
+    out.clear();
+    while (out.size() < n) {
+        if (memory.empty()) {
+            flush();
+            if (onDisk == 0)
+                break;
+            std::vector<uint32_t> segment(std::min<long long>(onDisk, segmentSize));
+            fseek(file, readOffset, SEEK_SET);
+            size_t read = fread(segment.data(), sizeof(uint32_t), segment.size(), file);
+            readOffset += (long)(read * sizeof(uint32_t));
+            onDisk = read ? onDisk - read : 0;
+            memory.insert(memory.end(), segment.begin(), segment.begin() + read);
+        }
+        while (!memory.empty() && out.size() < n) {
+            out.push_back(memory.front());
+            memory.pop_front();
+        }
+    }
+    return !out.empty();
+}
+
+bool SpillQueue::empty() const
+{
+    return memory.empty() && writeBuffer.empty() && onDisk == 0;
+}
+
+Explorer::Explorer(NondeterministicMachine const & machine, int tapeLen, ExploreSettings const & settings)
+: machine(machine)
+, tapeLen(tapeLen)
+, settings(settings)
+, initial(tapeLen)
+, tableUsed(0)
+{
+    if (this->settings.threads <= 0)
+        this->settings.threads = std::max(1u, std::thread::hardware_concurrency());
+    if (this->settings.frontierMemory == 0)
+        this->settings.frontierMemory = std::min(settings.memoryBudget / 8, maxFrontierMemory);
+    maxConfigs = std::min<size_t>(settings.memoryBudget / sizeof(Config), UINT32_MAX);
+}
+
+uint64_t Explorer::key(Config const & c) const
+{
+    uint64_t k = c.tapeHash ^ mix(~(uint64_t(c.state) << 32 | uint32_t(c.pos)));
+    return k ? k : 1;
+}
+
+unsigned char Explorer::symbolAt(uint32_t id, int cell) const
+{
+    // Walk up to the nearest ancestor that wrote this cell
+    for (; id != 0; id = store[id].parent) {
+        if (store[store[id].parent].pos == cell)
+            return store[id].written;
+    }
+    return initial[cell];
+}
+
+std::vector<unsigned char> Explorer::tape(uint32_t id) const
+{
+    std::vector<unsigned char> cells(tapeLen);
+    for (int i = 0; i < tapeLen; ++i) {
+        cells[i] = symbolAt(id, i);
+    }
+    return cells;
+}
+
+bool Explorer::insert(uint64_t key)
+{
+    // makeRoom keeps the table at most half full, so probing always ends.
+    size_t size = table.size();
+    for (size_t i = key % size; ; i = i + 1 < size ? i + 1 : 0) {
+        if (table[i] == key)
+            return false;
+        if (table[i] == 0) {
+            table[i] = key;
+            ++tableUsed;
+            return true;
+        }
+    }
+}
+
+// Makes room to store one more configuration, doubling the hash table once
+// it would pass half full. False if the record, or the old and new tables
+// side by side during the rehash, would take the search over budget.
+bool Explorer::makeRoom()
+{
+    size_t bytes = (store.size() + 1) * sizeof(Config) + frontierBytes;
+    if (store.size() >= maxConfigs || bytes + table.size() * sizeof(uint64_t) > settings.memoryBudget)
+        return false;
+    if ((tableUsed + 1) * 2 <= table.size())
+        return true;
+    size_t grown = table.size() * 2;
+    if (bytes + (table.size() + grown) * sizeof(uint64_t) > settings.memoryBudget)
+        return false;
+    std::vector<uint64_t> old(grown, 0);
+    old.swap(table);
+    tableUsed = 0;
+    for (uint64_t k : old) {
+        if (k)
+            insert(k);
+    }
+    return true;
+}
+
+void Explorer::expand(std::vector<uint32_t> const & batch, std::vector<std::vector<Config>> & children) const
+{
+    int threads = (int)children.size();
+    auto worker = [&](int t) {
+        std::vector<NondeterministicTransition> moves;
+        std::vector<Config> & out = children[t];
+        out.clear();
+        for (size_t i = t; i < batch.size(); i += threads) {
+            Config const & c = store[batch[i]];
+            unsigned char symbol = symbolAt(batch[i], c.pos);
+            moves.clear();
+            machine.transitions(c.state, symbol, moves);
+            for (NondeterministicTransition const & m : moves) {
+                Config child;
+                child.tapeHash = c.tapeHash ^ zobrist(c.pos, symbol) ^ zobrist(c.pos, m.write);
+                child.parent = batch[i];
+                child.pos = moveHead(c.pos, m.dir, tapeLen);
+                child.depth = c.depth + 1;
+                child.state = (uint16_t)m.nextState;
+                child.written = m.write;
+                out.push_back(child);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread & thread : pool) {
+        thread.join();
+    }
+}
+
+template <class Push>
+bool Explorer::merge(std::vector<std::vector<Config>> const & children, ExploreResult & result, Push push)
+{
+    for (std::vector<Config> const & part : children) {
+        for (Config const & child : part) {
+            if (!makeRoom()) {
+                result.budgetExceeded = true;
+                return false;
+            }
+            if (!insert(key(child))) {
+                ++result.duplicates;
+                continue;
+            }
+            uint32_t id = (uint32_t)store.size();
+            store.push_back(child);
+            ++result.configurations;
+            result.depth = std::max(result.depth, child.depth);
+            if (machine.accepting(child.state)) {
+                result.accepted = id;
+                return false;
+            }
+            push(id, child);
+        }
+    }
+    return true;
+}
+
+ExploreResult Explorer::explore()
+{
+    ExploreResult result = ExploreResult();
+    result.accepted = -1;
+
+    machine.reset(initial);
+    // Reserving only takes address space; pages are touched as records arrive
+    store.clear();
+    store.reserve(maxConfigs);
+    std::vector<uint64_t>(initialTableSize, 0).swap(table);
+    tableUsed = 0;
+    frontierBytes = 0;
+
+    Config root;
+    root.tapeHash = 0;
+    for (int i = 0; i < tapeLen; ++i) {
+        root.tapeHash ^= zobrist(i, initial[i]);
+    }
+    root.parent = 0;
+    root.pos = 0;
+    root.depth = 0;
+    root.state = (uint16_t)machine.initialState();
+    root.written = initial[0];
+    insert(key(root));
+    store.push_back(root);
+    result.configurations = 1;
+    if (machine.accepting(root.state)) {
+        result.accepted = 0;
+        return result;
+    }
+
+    std::vector<uint32_t> batch;
+    std::vector<std::vector<Config>> children(settings.threads);
+
+    if (settings.bestFirst) {
+        // Lowest score first, in a min-heap whose capacity counts against the budget
+        typedef std::pair<int, uint32_t> Entry;
+        std::vector<Entry> frontier;
+        std::greater<Entry> later;
+        frontier.push_back(Entry(machine.score(root.state, root.pos, 0), 0));
+        auto push = [&](uint32_t id, Config const & c) {
+            frontier.push_back(Entry(machine.score(c.state, c.pos, c.depth), id));
+            std::push_heap(frontier.begin(), frontier.end(), later);
+        };
+        while (!frontier.empty()) {
+            batch.clear();
+            while (!frontier.empty() && batch.size() < batchSize) {
+                std::pop_heap(frontier.begin(), frontier.end(), later);
+                batch.push_back(frontier.back().second);
+                frontier.pop_back();
+            }
+            frontierBytes = frontier.capacity() * sizeof(Entry);
+            expand(batch, children);
+            if (!merge(children, result, push))
+                break;
+        }
+    }
+    else {
+        // Each level keeps half the frontier memory; ids past it spill. Both
+        // levels also hold a segment being written and one being read.
+        size_t levelIds = settings.frontierMemory / 2 / sizeof(uint32_t);
+        frontierBytes = settings.frontierMemory + 4 * segmentSize * sizeof(uint32_t);
+        std::unique_ptr<SpillQueue> current(new SpillQueue(levelIds));
+        std::unique_ptr<SpillQueue> next(new SpillQueue(levelIds));
+        current->push(0);
+        auto push = [&](uint32_t id, Config const &) { next->push(id); };
+        bool searching = true;
+        while (searching && !current->empty()) {
+            while (searching && current->pop(batchSize, batch)) {
+                expand(batch, children);
+                searching = merge(children, result, push);
+            }
+            result.spilled += current->spilled();
+            std::swap(current, next);
+            next.reset(new SpillQueue(levelIds));
+        }
+        result.spilled += current->spilled();
+    }
+    return result;
+}
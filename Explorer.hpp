@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Machine.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <vector>
+
+struct NondeterministicTransition
+{
+    unsigned char write;
+    Direction dir;
+    int nextState;
+};
+
+// A machine whose transition relation may offer any number of moves for a
+// state and symbol. Unlike Machine it holds no run state of its own: the
+// explorer tracks states, which are small integers, and tapes of small symbols.
+struct NondeterministicMachine
+{
+    virtual ~NondeterministicMachine() {}
+    virtual int initialState() const = 0;
+    virtual void reset(std::vector<unsigned char> & tape) const = 0;
+    virtual void transitions(int state, unsigned char symbol, std::vector<NondeterministicTransition> & out) const = 0;
+    virtual bool accepting(int state) const = 0;
+    // Best-first search expands lower scores first.
+    virtual int score(int state, int pos, int depth) const { (void)state; (void)pos; return depth; }
+};
+
+// Walks right or left at will, marking cells, until it finds the marker
+// placed in the middle of the tape.
+std::unique_ptr<NondeterministicMachine> createMarkerSearch();
+
+// FIFO of configuration ids that keeps a bounded number in memory and
+// spills the rest to a temporary file in fixed-size segments. Ids come back
+// in memory-first order, which is all a level of breadth-first search needs.
+class SpillQueue
+{
+public:
+    explicit SpillQueue(size_t memoryLimit);
+    ~SpillQueue();
+    SpillQueue(SpillQueue const &) = delete;
+    SpillQueue & operator=(SpillQueue const &) = delete;
+
+    void push(uint32_t id);
+    // Moves up to n ids into out; false once the queue is empty.
+    bool pop(size_t n, std::vector<uint32_t> & out);
+    bool empty() const;
+    long long spilled() const { return spilledTotal; }
+
+private:
+    void flush();
+
+    size_t memoryLimit;
+    std::deque<uint32_t> memory;
+    std::vector<uint32_t> writeBuffer;
+    FILE * file;
+    long long onDisk;
+    long readOffset;
+    long writeOffset;
+    long long spilledTotal;
+};
+
+struct ExploreSettings
+{
+    bool bestFirst;
+    // Bytes for the configuration store, its hash table and the frontier.
+    // Records stay in memory, since a configuration's tape is rebuilt by
+    // walking its ancestors. The hash table grows as they arrive, and the old
+    // and new tables both count while it rehashes. A best-first frontier
+    // cannot spill, so all of it counts too.
+    size_t memoryBudget;
+    // Bytes of breadth-first frontier ids held in memory, split between the
+    // level being expanded and the next; the rest spill to a temporary file.
+    // Comes out of memoryBudget. 0 picks an eighth of the budget, at most 1 MB.
+    size_t frontierMemory;
+    int threads;
+};
+
+struct ExploreResult
+{
+    long long configurations;
+    long long duplicates;
+    long long spilled;
+    int depth;
+    // Id of the first accepting configuration found, or -1.
+    long long accepted;
+    bool budgetExceeded;
+};
+
+// Searches the configurations reachable by a nondeterministic machine on a
+// circular tape. Each configuration is stored as a delta against its parent
+// (the one cell the parent wrote) and deduplicated by a Zobrist fingerprint
+// of state, head and tape, updated incrementally so no tape is ever copied.
+// Fingerprints are 64 bits; a collision would silently merge two states.
+class Explorer
+{
+public:
+    Explorer(NondeterministicMachine const & machine, int tapeLen, ExploreSettings const & settings);
+    ExploreResult explore();
+    // Rebuilds the full tape of a stored configuration.
+    std::vector<unsigned char> tape(uint32_t id) const;
+
+private:
+    struct Config {
+        uint64_t tapeHash;
+        uint32_t parent;
+        int32_t pos;
+        int32_t depth;
+        uint16_t state;
+        unsigned char written;
+    };
+
+    uint64_t key(Config const & c) const;
+    unsigned char symbolAt(uint32_t id, int cell) const;
+    void expand(std::vector<uint32_t> const & batch, std::vector<std::vector<Config>> & children) const;
+    bool insert(uint64_t key);
+    bool makeRoom();
+    // Stores the new children and hands their ids to push. Returns false to stop.
+    template <class Push>
+    bool merge(std::vector<std::vector<Config>> const & children, ExploreResult & result, Push push);
+
+    NondeterministicMachine const & machine;
+    int tapeLen;
+    ExploreSettings settings;
+    std::vector<unsigned char> initial;
+    std::vector<Config> store;
+    std::vector<uint64_t> table;
+    size_t tableUsed;
+    size_t maxConfigs;
+    // Bytes the frontier holds, counted against the budget with the store
+    size_t frontierBytes;
+};
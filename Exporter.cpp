@@ -0,0 +1,106 @@
+#include "Exporter.hpp"
+#include <QFile>
+#include <QFuture>
+#include <QImage>
+#include <QPainter>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <cstdio>
+#include <deque>
+
+static QImage renderFrame(Simulation const & sim, int size, bool fixTape)
+{
+    QImage image(size, size, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    sim.render(painter, size, fixTape);
+    return image;
+}
+
+// Expands the frame pattern for one frame, counting the frame number
+// conversions so a pattern with none or several can be rejected.
+static QString frameFileName(QString const & pattern, int frame, int & conversions)
+{
+    QString name;
+    conversions = 0;
+    for (int i = 0; i < pattern.size(); ++i) {
+        if (pattern[i] != '%') {
+            name += pattern[i];
+            continue;
+        }
+        if (++i < pattern.size() && pattern[i] == '%') {
+            name += '%';
+            continue;
+        }
+        QChar fill = ' ';
+        if (i < pattern.size() && pattern[i] == '0') {
+            fill = '0';
+            ++i;
+        }
+        int width = 0;
+        while (i < pattern.size() && pattern[i].isDigit() && width < 100)
+            width = width * 10 + pattern[i++].digitValue();
+        if (i >= pattern.size() || pattern[i] != 'd') {
+            conversions = -1;
+            return QString();
+        }
+        name += QString("%1").arg(frame, width, 10, fill);
+        ++conversions;
+    }
+    return name;
+}
+
+bool isFramePattern(QString const & output)
+{
+    int conversions;
+    frameFileName(output, 0, conversions);
+    return output == "-" || conversions == 1;
+}
+
+int exportFrames(Simulation sim, ExportSettings const & settings)
+{
+    QFile pipe;
+    if (!isFramePattern(settings.output) || (settings.output == "-" && !pipe.open(stdout, QIODevice::WriteOnly))) {
+        return -1;
+    }
+    // One frame is a second of simulated time
+    sim.setRate(settings.stepsPerFrame);
+
+    // Keep a few frames per thread in flight; more only costs memory.
+    int const window = 4 * QThreadPool::globalInstance()->maxThreadCount();
+    std::deque<QFuture<QImage>> pending;
+    int written = 0;
+    bool ok = true;
+    auto writeNext = [&]() {
+        QImage image = pending.front().result();
+        pending.pop_front();
+        if (!ok)
+            return;
+        if (pipe.isOpen())
+            ok = image.save(&pipe, "PPM");
+        else {
+            int conversions;
+            ok = image.save(frameFileName(settings.output, written, conversions));
+        }
+        if (ok)
+            ++written;
+    };
+
+    for (int frame = 0; frame < settings.frames && ok; ++frame) {
+        if (frame > 0) {
+            if (sim.finished())
+                break;
+            sim.advance(1000000000, 0);
+        }
+        int size = settings.size;
+        bool fixTape = settings.fixTape;
+        pending.push_back(QtConcurrent::run([sim, size, fixTape]() { return renderFrame(sim, size, fixTape); }));
+        if ((int)pending.size() >= window)
+            writeNext();
+    }
+    while (!pending.empty())
+        writeNext();
+    pipe.close();
+    return ok ? written : -1;
+}
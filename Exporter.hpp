@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Simulation.hpp"
+#include <QString>
+
+struct ExportSettings
+{
+    // File name pattern with one %d, %0Nd or %Nd for the frame number and
+    // %% for a literal percent sign, such as "frame%06d.png", or "-" to
+    // stream PPM frames to stdout for an encoder, e.g.
+    //   turingmachine --export=- | ffmpeg -f image2pipe -c:v ppm -i - run.mp4
+    QString output;
+    int frames;
+    int size;
+    double stepsPerFrame;
+    bool fixTape;
+};
+
+// Whether output is "-" or a file name pattern as described above.
+bool isFramePattern(QString const & output);
+
+// Renders the simulation frame by frame on the global thread pool, writing
+// the frames in order. Stops early once the machine has halted and settled.
+// Returns the number of frames written, or -1 if writing failed.
+int exportFrames(Simulation sim, ExportSettings const & settings);
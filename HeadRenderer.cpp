@@ -0,0 +1,56 @@
+#include "HeadRenderer.hpp"
+#include <QPainter>
+
+static QPainterPath const & boxPath()
+{
+    static QPainterPath const box = []() {
+        QPainterPath path;
+        path.addRect(-.5, -1., 1., 1.);
+        return path;
+    }();
+    return box;
+}
+
+// The default font scaled so its ascent is size units
+static QFont labelFont(qreal size)
+{
+    QFont font;
+    font.setPointSizeF(font.pointSizeF() * size / QFontMetricsF(font).ascent());
+    return font;
+}
+
+static void renderBox(QPainter & painter, QColor const & fill)
+{
+    QPainterPath const & box = boxPath();
+    painter.save();
+    painter.setPen(QPen(Qt::black, 0.05, Qt::SolidLine, Qt::SquareCap, Qt::MiterJoin));
+    painter.setBrush(fill);
+    painter.drawPath(box);
+    painter.restore();
+}
+
+void renderHead(Machine const & machine, QPainter & painter)
+{
+    std::vector<QColor> registers = machine.registers();
+    // Machines without registers have two-letter states, so get a smaller
+    // label. Measuring fonts is slow, so each is built once.
+    static QFont const smallFont = labelFont(7.);
+    static QFont const largeFont = labelFont(10.);
+    int labelHeight = registers.empty() ? 8 : 10;
+
+    painter.save();
+    painter.setFont(registers.empty() ? smallFont : largeFont);
+    painter.scale(1. / 4., 1. / 4.);
+    painter.setPen(QPen(Qt::black, 0., Qt::SolidLine));
+    painter.setBrush(Qt::black);
+    painter.drawText(-5, 2, 10, labelHeight, Qt::AlignHCenter, machine.label());
+    painter.restore();
+
+    painter.save();
+    painter.translate(-.75 * (int(registers.size()) - 1), 4.5);
+    for (QColor const & r : registers) {
+        renderBox(painter, r);
+        painter.translate(1.5, 0.);
+    }
+    painter.restore();
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Machine.hpp"
+
+class QPainter;
+
+// Draws the machine's head in head coordinates: its state label, with its
+// registers in a row of boxes beneath.
+void renderHead(Machine const & machine, QPainter & painter);
@@ -1,5 +1,5 @@
 #include "Machine.hpp"
-#include "TuringMachine.hpp"
+#include "PagedTape.hpp"
 #include <algorithm>
 
 struct InsertionSort : public Machine
@@ -15,70 +15,106 @@ struct InsertionSort : public Machine
         int escCtr;
     } r;
     int tapeLen;
+    Workload workload;
+
+    InsertionSort(Workload workload) : workload(workload) {}
 
     virtual ~InsertionSort() {}
 
+    virtual std::unique_ptr<Machine> clone() const
+    {
+        return std::unique_ptr<InsertionSort>(new InsertionSort(*this));
+    }
+
     virtual void reset(std::vector<QColor> & tape)
     {
         tapeLen = (int)tape.size();
-        for (int i = 0; i < tapeLen; ++i) {
-            tape[i] = QColor::fromHslF(qreal(i) / tapeLen, .9, .5);
-        }
-        std::shuffle(tape.begin(), tape.end(), rng);
+        fillWorkload(tape, workload);
         state = SCAN;
         r.lo = r.hi = tape[0];
         r.samp = Qt::black;
         r.escCtr = 0;
     }
 
-    struct Transition {
-        QColor write;
-        Direction dir;
-        State nextState;
-        Registers r;
-    };
-    Transition eval(QColor const & current) const
+    // Applies one transition to the cell under the head, rewriting it and
+    // updating the state and registers in place, and returns the head's move.
+    // Only the colours that change are copied.
+    Direction step(QColor & cell)
     {
         switch (state) {
             default:
             case SCAN:
                 if (r.escCtr == tapeLen) {
-                    return Transition{ current, LEFT, HALT, { Qt::black, Qt::black, Qt::black, 0 } };
+                    state = HALT;
+                    r.lo = r.hi = r.samp = Qt::black;
+                    r.escCtr = 0;
+                    return LEFT;
                 }
-                else if (hueSep(current, r.lo) + hueSep(r.lo, r.hi) < 1.) {
-                    return Transition{ current, LEFT, SCAN, { current, r.hi, Qt::black, r.escCtr + 1 } };
-                }
-                else {
-                    return Transition{ current, RIGHT, LOCATE, { r.lo, r.hi, current, r.escCtr + 1 } };
+                ++r.escCtr;
+                if (hueSep(cell, r.lo) + hueSep(r.lo, r.hi) < 1.) {
+                    r.lo = cell;
+                    r.samp = Qt::black;
+                    return LEFT;
                 }
+                r.samp = cell;
+                state = LOCATE;
+                return RIGHT;
 
             case LOCATE:
-                if (hueSep(r.lo, current) + hueSep(current, r.samp) < 1.) {
-                    return Transition{ current, RIGHT, LOCATE, { r.lo, r.hi, r.samp, r.escCtr } };
-                }
-                else {
-                    return Transition{ current, LEFT, INSERT, { r.lo, r.hi, r.samp, r.escCtr } };
+                if (hueSep(r.lo, cell) + hueSep(cell, r.samp) < 1.) {
+                    return RIGHT;
                 }
+                state = INSERT;
+                return LEFT;
 
             case INSERT:
-                if (hueSep(r.lo, current) + hueSep(current, r.samp) < 1.) {
-                    return Transition{ r.samp, LEFT, INSERT, { r.lo, r.hi, current, r.escCtr } };
-                }
-                else {
-                    return Transition{ r.samp, LEFT, SCAN, { r.lo, r.hi, Qt::black, r.escCtr } };
+                if (hueSep(r.lo, cell) + hueSep(cell, r.samp) < 1.) {
+                    std::swap(cell, r.samp);
+                    return LEFT;
                 }
+                cell = r.samp;
+                r.samp = Qt::black;
+                state = SCAN;
+                return LEFT;
 
             case HALT:
-                return Transition{ current, LEFT, HALT, { r.lo, r.hi, r.samp, 0 } };
+                r.escCtr = 0;
+                return LEFT;
         }
     }
 
     virtual TapeTransition advance(QColor const & current)
     {
-        Transition t = eval(current);
-        state = t.nextState;
-        r = t.r;
-        return TapeTransition{ t.write, t.dir };
+        QColor cell = current;
+        Direction dir = step(cell);
+        return TapeTransition{ cell, dir };
+    }
+
+    template <class Tape>
+    StepResult advanceTape(Tape & tape, int & pos, long long n)
+    {
+        long long steps = 0;
+        while (state != HALT && steps < n) {
+            QColor cell = tape.get(pos);
+            Direction dir = step(cell);
+            tape.set(pos, cell);
+            if (state != HALT) {
+                pos = moveHead(pos, dir, tapeLen);
+            }
+            ++steps;
+        }
+        return StepResult{ steps, state == HALT };
+    }
+
+    virtual StepResult advanceN(std::vector<QColor> & tape, int & pos, long long n)
+    {
+        DenseTape dense{ tape };
+        return advanceTape(dense, pos, n);
+    }
+
+    virtual StepResult advanceN(PagedTape & tape, int & pos, long long n)
+    {
+        return advanceTape(tape, pos, n);
     }
 
     virtual bool halted() const
@@ -86,7 +122,7 @@ struct InsertionSort : public Machine
         return state == HALT;
     }
 
-    char const * label() const
+    virtual char const * label() const
     {
         switch (state) {
             default:
@@ -97,33 +133,14 @@ struct InsertionSort : public Machine
         }
     }
 
-    virtual void renderHead(QPainter & painter, TuringMachine const & tm) const
+    virtual std::vector<QColor> registers() const
     {
-        QFont labelFont;
-        qreal fontScale = 10. / QFontMetricsF(labelFont).ascent();
-        labelFont.setPointSizeF(labelFont.pointSizeF() * fontScale);
-
-        painter.save();
-        painter.setFont(labelFont);
-        painter.scale(1. / 4., 1. / 4.);
-        painter.setPen(QPen(Qt::black, 0., Qt::SolidLine));
-        painter.setBrush(Qt::black);
-        painter.drawText(-5, 2, 10, 10, Qt::AlignHCenter, label());
-        painter.restore();
-
-        painter.save();
-        painter.translate(-1.5, 4.5);
-        tm.renderBox(painter, r.lo);
-        painter.translate(1.5, 0.);
-        tm.renderBox(painter, r.samp);
-        painter.translate(1.5, 0.);
-        tm.renderBox(painter, r.hi);
-        painter.restore();
+        return { r.lo, r.samp, r.hi };
     }
 };
 
-std::unique_ptr<Machine> createInsertionSort()
+std::unique_ptr<Machine> createInsertionSort(Workload workload)
 {
-    return std::unique_ptr<InsertionSort>(new InsertionSort());
+    return std::unique_ptr<InsertionSort>(new InsertionSort(workload));
 }
 
@@ -0,0 +1,47 @@
+#include "Machine.hpp"
+#include "PagedTape.hpp"
+#include <climits>
+
+std::mt19937 rng;
+
+std::unique_ptr<Machine> createMachine(std::string const & name, Workload workload)
+{
+    if (name == "insertionsort")
+        return createInsertionSort(workload);
+    if (name == "mergesort")
+        return createMergeSort(workload);
+    if (name == "sieve")
+        return createSieve();
+    return nullptr;
+}
+
+std::vector<std::string> machineNames()
+{
+    return { "insertionsort", "mergesort", "sieve" };
+}
+
+int minimumLength(std::string const & name)
+{
+    return name == "sieve" ? 2 : 1;
+}
+
+int maximumLength(std::string const & name)
+{
+    return name == "sieve" ? INT_MAX : maxDistinctHues;
+}
+
+StepResult Machine::advanceN(std::vector<QColor> & tape, int & pos, long long n)
+{
+    DenseTape dense{ tape };
+    return stepTape(*this, dense, pos, n);
+}
+
+StepResult Machine::advanceN(PagedTape & tape, int & pos, long long n)
+{
+    return stepTape(*this, tape, pos, n);
+}
+
+long long run(Machine & machine, std::vector<QColor> & tape, int & pos, long long maxSteps)
+{
+    return machine.advanceN(tape, pos, maxSteps).steps;
+}
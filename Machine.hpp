@@ -1,10 +1,17 @@
 #pragma once
 
-#include <QPainter>
+#include "Workload.hpp"
+#include <QColor>
 #include <cmath>
 #include <memory>
+#include <random>
+#include <string>
+#include <vector>
 
-class TuringMachine;
+class PagedTape;
+class RunTape;
+
+extern std::mt19937 rng;
 
 enum Direction { LEFT, RIGHT };
 
@@ -14,18 +21,87 @@ struct TapeTransition
     Direction dir;
 };
 
+struct StepResult
+{
+    long long steps;
+    bool halted;
+};
+
+inline int moveHead(int pos, Direction dir, int tapeLen)
+{
+    return (pos + (dir == LEFT ? tapeLen - 1 : 1)) % tapeLen;
+}
+
+// A plain vector seen through the get/set/size interface of PagedTape.
+struct DenseTape
+{
+    std::vector<QColor> & cells;
+    int size() const { return (int)cells.size(); }
+    QColor const & get(int i) const { return cells[i]; }
+    void set(int i, QColor const & c) { cells[i] = c; }
+};
+
 struct Machine
 {
     virtual ~Machine() {}
+    virtual std::unique_ptr<Machine> clone() const = 0;
     virtual void reset(std::vector<QColor> & tape) = 0;
+    // Run-length counterpart of reset. The default goes through a dense tape.
+    virtual void resetRuns(RunTape & tape);
     virtual TapeTransition advance(QColor const & current) = 0;
-    virtual void renderHead(QPainter & painter, TuringMachine const & tm) const = 0;
+    // Takes up to n steps directly on the tape, for when nobody is watching
+    // the intermediate steps. The defaults go through advance(); machines
+    // override both with one templated loop of their own.
+    virtual StepResult advanceN(std::vector<QColor> & tape, int & pos, long long n);
+    virtual StepResult advanceN(PagedTape & tape, int & pos, long long n);
+    // What the head shows: a short state name, and the registers drawn as
+    // boxes beneath it. Drawing them is up to the GUI (see HeadRenderer.hpp).
+    virtual char const * label() const = 0;
+    virtual std::vector<QColor> registers() const { return std::vector<QColor>(); }
     virtual bool halted() const = 0;
+    // Like advance, also reporting whether the machine came back exactly as
+    // it was, so the same transition applies across a whole run of such cells.
+    virtual TapeTransition advanceRun(QColor const & current, bool & repeats)
+    {
+        repeats = false;
+        return advance(current);
+    }
 };
 
-std::unique_ptr<Machine> createInsertionSort();
-std::unique_ptr<Machine> createMergeSort();
+// The default stepping loop, through advance(). Tape needs get(), set() and
+// size(), like PagedTape or DenseTape.
+template <class Tape>
+StepResult stepTape(Machine & machine, Tape & tape, int & pos, long long n)
+{
+    int len = tape.size();
+    long long steps = 0;
+    while (!machine.halted() && steps < n) {
+        TapeTransition t = machine.advance(tape.get(pos));
+        tape.set(pos, t.write);
+        if (!machine.halted()) {
+            pos = moveHead(pos, t.dir, len);
+        }
+        ++steps;
+    }
+    return StepResult{ steps, machine.halted() };
+}
+
+std::unique_ptr<Machine> createInsertionSort(Workload workload = UNIFORM);
+std::unique_ptr<Machine> createMergeSort(Workload workload = UNIFORM);
 std::unique_ptr<Machine> createSieve();
+// Looks a machine up by name; returns null for unknown names. The workload
+// only matters to the sorting machines.
+std::unique_ptr<Machine> createMachine(std::string const & name, Workload workload = UNIFORM);
+std::vector<std::string> machineNames();
+// The range of tape lengths the named machine is sure to halt on. The sieve
+// needs a cell past its marker to search, and the sorters need every hue on
+// the tape to be distinct (see Workload.hpp).
+int minimumLength(std::string const & name);
+int maximumLength(std::string const & name);
+
+// Steps the machine until it halts or maxSteps have been taken. Returns the
+// number of steps taken.
+long long run(Machine & machine, std::vector<QColor> & tape, int & pos, long long maxSteps);
 
 inline float hueSep(QColor const & a, QColor const & b)
 {
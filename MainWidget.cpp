@@ -3,50 +3,64 @@
 #include "ResetDialog.hpp"
 
 static int tapeLen = 40;
+static std::string machineName = "sieve";
+static std::string workloadSpec = "uniform";
 
 MainWidget::MainWidget(QWidget * parent)
 : QWidget(parent)
 {
     layout = new QGridLayout(this);
-    tm = new TuringMachine(createSieve(), tapeLen, this);
+    tm = new TuringMachine(createMachine(machineName), tapeLen, this);
     slider = new QSlider(Qt::Vertical, this);
-    slider->setRange(2000, 11000);
-    slider->setValue(10000);
-    slider->setInvertedAppearance(true);
+    slider->setRange(0, TuringMachine::rateUnlimited);
+    slider->setValue(1);
     button = new QPushButton("New", this);
     checkBox = new QCheckBox("Fix tape", this);
+    rateLabel = new QLabel(this);
     layout->addWidget(tm, 0, 0, 3, 2);
     layout->addWidget(checkBox, 0, 1, 1, 2);
     layout->addWidget(slider, 1, 2, 1, 1);
     layout->addWidget(button, 2, 1, 1, 2);
+    layout->addWidget(rateLabel, 3, 0, 1, 3);
     layout->setColumnStretch(0, 1);
     layout->setRowStretch(1, 1);
     setLayout(layout);
     QObject::connect(checkBox, SIGNAL(stateChanged(int)), tm, SLOT(setFixTape(int)));
-    QObject::connect(slider, SIGNAL(valueChanged(int)), tm, SLOT(setSpeed(int)));
+    QObject::connect(slider, SIGNAL(valueChanged(int)), tm, SLOT(setRate(int)));
+    QObject::connect(tm, SIGNAL(rateChanged(double, double)), this, SLOT(showRate(double, double)));
     QObject::connect(button, SIGNAL(clicked()), this, SLOT(showResetDialog()));
 }
 
 void MainWidget::showResetDialog()
 {
-    ResetDialog dialog(tapeLen);
+    ResetDialog dialog(tapeLen, machineName, workloadSpec);
     bool wasPaused = tm->pause();
     int tmpTapeLen = dialog.exec();
     if (tmpTapeLen) {
         tapeLen = tmpTapeLen;
-        tm->reset(tapeLen);
+        machineName = dialog.machine();
+        workloadSpec = dialog.workload();
+        Workload workload = UNIFORM;
+        parseWorkload(workloadSpec, workload);
+        tm->reset(createMachine(machineName, workload), tapeLen);
     }
     if (!wasPaused) {
         tm->unpause();
     }
 }
 
+void MainWidget::showRate(double requested, double achieved)
+{
+    QString target = requested > 0. ? QString::number(requested, 'g', 4) : QString("unlimited");
+    rateLabel->setText(QString("%1 steps/s (requested %2)").arg(achieved, 0, 'g', 4).arg(target));
+}
+
 QSize MainWidget::sizeHint() const
 {
     QMargins margins = contentsMargins();
     QSize tmSize = tm->sizeHint();
     QSize sliderSize = slider->sizeHint();
     return QSize(tmSize.width() + layout->horizontalSpacing() + sliderSize.width() + margins.left() + margins.right(),
-                 tmSize.height() + margins.top() + margins.bottom());
+                 tmSize.height() + layout->verticalSpacing() + rateLabel->sizeHint().height() + margins.top() + margins.bottom());
 }
 
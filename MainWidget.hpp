@@ -3,6 +3,7 @@
 #include "TuringMachine.hpp"
 #include <QCheckBox>
 #include <QGridLayout>
+#include <QLabel>
 #include <QPushButton>
 #include <QSlider>
 #include <QWidget>
@@ -17,6 +18,7 @@ public:
 
 public slots:
     void showResetDialog();
+    void showRate(double requested, double achieved);
 
 private:
     QGridLayout * layout;
@@ -24,5 +26,6 @@ private:
     QSlider * slider;
     QPushButton * button;
     QCheckBox * checkBox;
+    QLabel * rateLabel;
 };
 
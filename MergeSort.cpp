@@ -1,5 +1,5 @@
 #include "Machine.hpp"
-#include "TuringMachine.hpp"
+#include "PagedTape.hpp"
 #include <algorithm>
 
 // Black version is a little easier to visualize
@@ -19,89 +19,121 @@ struct MergeSort : public Machine
     } r;
     int tapeLen;
     int escCtr;
+    Workload workload;
+
+    MergeSort(Workload workload) : workload(workload) {}
 
     virtual ~MergeSort() {}
 
+    virtual std::unique_ptr<Machine> clone() const
+    {
+        return std::unique_ptr<MergeSort>(new MergeSort(*this));
+    }
+
     virtual void reset(std::vector<QColor> & tape)
     {
         tapeLen = (int)tape.size();
-        for (int i = 0; i < tapeLen; ++i) {
-            tape[i] = QColor::fromHslF(qreal(i) / tapeLen, .9, .5);
-        }
-        std::shuffle(tape.begin(), tape.end(), rng);
+        fillWorkload(tape, workload);
         state = SCAN;
         r.lo = r.hi = tape[0];
         r.samp = Qt::black;
         escCtr = 0;
     }
 
-    struct Transition {
-        QColor write;
-        Direction dir;
-        State nextState;
-        Registers r;
-    };
-    Transition eval(QColor const & current) const
+    // Applies one transition to the cell under the head, rewriting it and
+    // updating the state and registers in place, and returns the head's move.
+    // Only the colours that change are copied.
+    Direction step(QColor & cell)
     {
+        if (state == SCAN) { escCtr++; } else { escCtr = 0; }
+        if (escCtr == tapeLen) { state = HALT; }
         switch (state) {
             default:
             case SCAN:
-                if (hueSep(current, r.lo) + hueSep(r.lo, r.hi) < 1.) {
-                    return Transition{ current, LEFT, SCAN, { current, r.hi, Qt::black } };
-                }
-                else {
-                    #if AllowBlackTape()
-                    return Transition{ Qt::black, RIGHT, LOCATE, { r.lo, current, current } };
-                    #else
-                    return Transition{ current, RIGHT, LOCATE, { r.lo, current, current } };
-                    #endif
+                if (hueSep(cell, r.lo) + hueSep(r.lo, r.hi) < 1.) {
+                    r.lo = cell;
+                    r.samp = Qt::black;
+                    return LEFT;
                 }
+                r.hi = r.samp = cell;
+                #if AllowBlackTape()
+                cell = Qt::black;
+                #endif
+                state = LOCATE;
+                return RIGHT;
 
             case LOCATE:
-                if (hueSep(r.lo, current) + hueSep(current, r.samp) < 1.) {
-                    return Transition{ current, RIGHT, LOCATE, { r.lo, r.hi, r.samp } };
-                }
-                else {
-                    return Transition{ current, LEFT, INSERT, { r.lo, r.hi, r.samp } };
+                if (hueSep(r.lo, cell) + hueSep(cell, r.samp) < 1.) {
+                    return RIGHT;
                 }
+                state = INSERT;
+                return LEFT;
 
             case INSERT:
                 #if AllowBlackTape()
-                if (current != Qt::black) {
+                if (cell != Qt::black) {
                 #else
-                if (hueSep(r.lo, current) + hueSep(current, r.samp) < 1.) {
+                if (hueSep(r.lo, cell) + hueSep(cell, r.samp) < 1.) {
                 #endif
-                    return Transition{ r.samp, LEFT, INSERT, { r.lo, r.hi, current } };
-                }
-                else {
-                    return Transition{ r.samp, LEFT, FETCH, { r.lo, r.hi, Qt::black } };
+                    std::swap(cell, r.samp);
+                    return LEFT;
                 }
+                cell = r.samp;
+                r.samp = Qt::black;
+                state = FETCH;
+                return LEFT;
 
             case FETCH:
-                if (hueSep(r.lo, current) + hueSep(current, r.hi) < 1.) {
+                if (hueSep(r.lo, cell) + hueSep(cell, r.hi) < 1.) {
+                    r.hi = r.samp = cell;
                     #if AllowBlackTape()
-                    return Transition{ Qt::black, RIGHT, LOCATE, { r.lo, current, current } };
-                    #else
-                    return Transition{ current, RIGHT, LOCATE, { r.lo, current, current } };
+                    cell = Qt::black;
                     #endif
+                    state = LOCATE;
+                    return RIGHT;
                 }
-                else {
-                    return Transition{ current, LEFT, SCAN, { current, current, Qt::black } };
-                }
+                r.lo = r.hi = cell;
+                r.samp = Qt::black;
+                state = SCAN;
+                return LEFT;
 
             case HALT:
-                return Transition{ current, LEFT, HALT, { r.lo, r.hi, r.samp } };
+                return LEFT;
         }
     }
 
     virtual TapeTransition advance(QColor const & current)
     {
-        if (state == SCAN) { escCtr++; } else { escCtr = 0; }
-        if (escCtr == tapeLen) { state = HALT; }
-        Transition t = eval(current);
-        state = t.nextState;
-        r = t.r;
-        return TapeTransition{ t.write, t.dir };
+        QColor cell = current;
+        Direction dir = step(cell);
+        return TapeTransition{ cell, dir };
+    }
+
+    template <class Tape>
+    StepResult advanceTape(Tape & tape, int & pos, long long n)
+    {
+        long long steps = 0;
+        while (state != HALT && steps < n) {
+            QColor cell = tape.get(pos);
+            Direction dir = step(cell);
+            tape.set(pos, cell);
+            if (state != HALT) {
+                pos = moveHead(pos, dir, tapeLen);
+            }
+            ++steps;
+        }
+        return StepResult{ steps, state == HALT };
+    }
+
+    virtual StepResult advanceN(std::vector<QColor> & tape, int & pos, long long n)
+    {
+        DenseTape dense{ tape };
+        return advanceTape(dense, pos, n);
+    }
+
+    virtual StepResult advanceN(PagedTape & tape, int & pos, long long n)
+    {
+        return advanceTape(tape, pos, n);
     }
 
     virtual bool halted() const
@@ -109,7 +141,7 @@ struct MergeSort : public Machine
         return state == HALT;
     }
 
-    char const * label() const
+    virtual char const * label() const
     {
         switch (state) {
             default:
@@ -121,33 +153,14 @@ struct MergeSort : public Machine
         }
     }
 
-    virtual void renderHead(QPainter & painter, TuringMachine const & tm) const
+    virtual std::vector<QColor> registers() const
     {
-        QFont labelFont;
-        qreal fontScale = 10. / QFontMetricsF(labelFont).ascent();
-        labelFont.setPointSizeF(labelFont.pointSizeF() * fontScale);
-
-        painter.save();
-        painter.setFont(labelFont);
-        painter.scale(1. / 4., 1. / 4.);
-        painter.setPen(QPen(Qt::black, 0., Qt::SolidLine));
-        painter.setBrush(Qt::black);
-        painter.drawText(-5, 2, 10, 10, Qt::AlignHCenter, label());
-        painter.restore();
-
-        painter.save();
-        painter.translate(-1.5, 4.5);
-        tm.renderBox(painter, r.lo);
-        painter.translate(1.5, 0.);
-        tm.renderBox(painter, r.samp);
-        painter.translate(1.5, 0.);
-        tm.renderBox(painter, r.hi);
-        painter.restore();
+        return { r.lo, r.samp, r.hi };
     }
 };
 
-std::unique_ptr<Machine> createMergeSort()
+std::unique_ptr<Machine> createMergeSort(Workload workload)
 {
-    return std::unique_ptr<MergeSort>(new MergeSort());
+    return std::unique_ptr<MergeSort>(new MergeSort(workload));
 }
 
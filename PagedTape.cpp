@@ -0,0 +1,88 @@
+#include "PagedTape.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+PagedTape::PagedTape()
+: len(0)
+{
+}
+
+void PagedTape::assign(std::vector<QColor> const & cells)
+{
+    len = (int)cells.size();
+    pages.clear();
+    for (int begin = 0; begin < len; begin += pageSize) {
+        auto end = cells.begin() + std::min(len, begin + pageSize);
+        pages.push_back(std::make_shared<Page>(cells.begin() + begin, end));
+    }
+}
+
+void PagedTape::set(int i, QColor const & c)
+{
+    std::shared_ptr<Page> & page = pages[i >> pageBits];
+    QColor & cell = (*page)[i & (pageSize - 1)];
+    if (cell == c) {
+        return;
+    }
+    // Only this copy can raise the count of a page it holds, so a count of
+    // one can't go stale; a stale higher count just costs a spare copy. The
+    // fence orders our write after other copies' reads of the page.
+    if (page.use_count() > 1) {
+        page = std::make_shared<Page>(*page);
+    }
+    else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    (*page)[i & (pageSize - 1)] = c;
+}
+
+int PagedTape::privatePages() const
+{
+    int count = 0;
+    for (auto const & page : pages) {
+        if (page.use_count() == 1)
+            ++count;
+    }
+    return count;
+}
+
+std::vector<QColor> PagedTape::toVector() const
+{
+    std::vector<QColor> cells;
+    cells.reserve(len);
+    for (auto const & page : pages) {
+        cells.insert(cells.end(), page->begin(), page->end());
+    }
+    return cells;
+}
+
+Branch Branch::fork() const
+{
+    return Branch{ machine->clone(), tape, pos, steps };
+}
+
+long long run(Machine & machine, PagedTape & tape, int & pos, long long maxSteps)
+{
+    return machine.advanceN(tape, pos, maxSteps).steps;
+}
+
+void runBranches(std::vector<Branch> & branches, long long maxSteps)
+{
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int i = next++; i < (int)branches.size(); i = next++) {
+            Branch & branch = branches[i];
+            branch.steps += run(*branch.machine, branch.tape, branch.pos, maxSteps);
+        }
+    };
+    int threads = std::min<int>(branches.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread & thread : pool) {
+        thread.join();
+    }
+}
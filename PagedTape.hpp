@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Machine.hpp"
+#include <memory>
+#include <vector>
+
+// A circular tape split into reference-counted pages. Copies share every
+// page, and a page is only duplicated when a copy first changes one of its
+// cells, so forking costs a page table rather than the whole tape.
+class PagedTape
+{
+public:
+    static int const pageBits = 12;
+    static int const pageSize = 1 << pageBits;
+
+    PagedTape();
+    void assign(std::vector<QColor> const & cells);
+    int size() const { return len; }
+    QColor const & get(int i) const { return (*pages[i >> pageBits])[i & (pageSize - 1)]; }
+    void set(int i, QColor const & c);
+    int pageCount() const { return (int)pages.size(); }
+    // Pages referenced by no other copy of the tape.
+    int privatePages() const;
+    std::vector<QColor> toVector() const;
+
+private:
+    typedef std::vector<QColor> Page;
+
+    int len;
+    std::vector<std::shared_ptr<Page>> pages;
+};
+
+// A machine partway through a run on a paged tape.
+struct Branch
+{
+    std::unique_ptr<Machine> machine;
+    PagedTape tape;
+    int pos;
+    long long steps;
+
+    // Copies the machine and shares the tape's pages.
+    Branch fork() const;
+};
+
+long long run(Machine & machine, PagedTape & tape, int & pos, long long maxSteps);
+// Runs each branch for up to maxSteps more steps, spreading them over all cores.
+void runBranches(std::vector<Branch> & branches, long long maxSteps);
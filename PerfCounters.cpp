@@ -0,0 +1,168 @@
+#include "PerfCounters.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+
+// Group fd values for openCounter besides a real leader.
+static int const NEW_GROUP = -1;
+static int const NO_GROUP = -2;
+
+static int openCounter(PerfCounters::Event e, int groupFd)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    // Group members follow their leader, which starts disabled.
+    attr.disabled = groupFd < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    if (groupFd != NO_GROUP)
+        attr.read_format |= PERF_FORMAT_GROUP;
+    switch (e) {
+        default:
+        case PerfCounters::CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfCounters::INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfCounters::BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PerfCounters::L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PerfCounters::LLC_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+    }
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, groupFd < 0 ? -1 : groupFd, 0);
+}
+
+PerfCounters::PerfCounters()
+{
+    int leader = openCounter(CYCLES, NEW_GROUP);
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        fds[e] = e == CYCLES ? leader : leader >= 0 ? openCounter(Event(e), leader) : -1;
+        grouped[e] = fds[e] >= 0;
+        if (fds[e] < 0)
+            fds[e] = openCounter(Event(e), NO_GROUP);
+        wasMeasured[e] = false;
+        counts[e] = 0.;
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        if (fds[e] >= 0)
+            close(fds[e]);
+    }
+}
+
+void PerfCounters::start()
+{
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        if (fds[e] >= 0 && (e == CYCLES || !grouped[e])) {
+            unsigned long flags = grouped[e] ? PERF_IOC_FLAG_GROUP : 0;
+            ioctl(fds[e], PERF_EVENT_IOC_RESET, flags);
+            ioctl(fds[e], PERF_EVENT_IOC_ENABLE, flags);
+        }
+    }
+}
+
+void PerfCounters::stop()
+{
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        if (fds[e] >= 0 && (e == CYCLES || !grouped[e]))
+            ioctl(fds[e], PERF_EVENT_IOC_DISABLE, grouped[e] ? PERF_IOC_FLAG_GROUP : 0);
+    }
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        counts[e] = 0.;
+        wasMeasured[e] = false;
+    }
+
+    // A group reads as { nr, time_enabled, time_running, value[nr] }, with
+    // the values in the order the members joined.
+    unsigned long long values[3 + EVENT_COUNT];
+    if (grouped[CYCLES] && read(fds[CYCLES], values, sizeof(values)) > 0 && values[2] > 0) {
+        double scale = double(values[1]) / double(values[2]);
+        unsigned long long i = 0;
+        for (int e = 0; e < EVENT_COUNT && i < values[0]; ++e) {
+            if (grouped[e]) {
+                counts[e] = double(values[3 + i++]) * scale;
+                wasMeasured[e] = true;
+            }
+        }
+    }
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        if (fds[e] >= 0 && !grouped[e] && read(fds[e], values, 3 * sizeof(values[0])) == 3 * sizeof(values[0]) && values[2] > 0) {
+            counts[e] = double(values[0]) * double(values[1]) / double(values[2]);
+            wasMeasured[e] = true;
+        }
+    }
+}
+
+#else
+
+PerfCounters::PerfCounters()
+{
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        fds[e] = -1;
+        grouped[e] = false;
+        wasMeasured[e] = false;
+        counts[e] = 0.;
+    }
+}
+
+PerfCounters::~PerfCounters() {}
+void PerfCounters::start() {}
+void PerfCounters::stop() {}
+
+#endif
+
+bool PerfCounters::available(Event e) const
+{
+    return fds[e] >= 0;
+}
+
+bool PerfCounters::anyAvailable() const
+{
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        if (fds[e] >= 0)
+            return true;
+    }
+    return false;
+}
+
+bool PerfCounters::measured(Event e) const
+{
+    return wasMeasured[e];
+}
+
+double PerfCounters::count(Event e) const
+{
+    return counts[e];
+}
+
+char const * PerfCounters::name(Event e)
+{
+    switch (e) {
+        default:
+        case CYCLES:        return "cycles";
+        case INSTRUCTIONS:  return "instructions";
+        case BRANCH_MISSES: return "branch_misses";
+        case L1D_MISSES:    return "l1d_misses";
+        case LLC_MISSES:    return "llc_misses";
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// Hardware performance counters around a stretch of code, read through
+// perf_event_open on Linux. The counters are opened as one group led by
+// cycles, so the kernel schedules them together and their ratios hold even
+// when it multiplexes. An event the kernel won't add to the group is counted
+// on its own instead. Counters the kernel refuses (or every counter, on
+// other platforms) report available() == false and read as zero.
+class PerfCounters
+{
+public:
+    enum Event {
+        CYCLES,
+        INSTRUCTIONS,
+        BRANCH_MISSES,
+        L1D_MISSES,
+        LLC_MISSES,
+        EVENT_COUNT
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(PerfCounters const &) = delete;
+    PerfCounters & operator=(PerfCounters const &) = delete;
+
+    void start();
+    void stop();
+    bool available(Event e) const;
+    bool anyAvailable() const;
+    // Whether the kernel actually ran the counter between start() and stop().
+    // It may not, say when the NMI watchdog holds a counter the group needs.
+    bool measured(Event e) const;
+    // Counts between start() and stop(), scaled up if the kernel multiplexed the counter.
+    double count(Event e) const;
+    static char const * name(Event e);
+
+private:
+    int fds[EVENT_COUNT];
+    bool grouped[EVENT_COUNT];
+    bool wasMeasured[EVENT_COUNT];
+    double counts[EVENT_COUNT];
+};
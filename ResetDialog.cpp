@@ -1,28 +1,48 @@
+#include "Machine.hpp"
 #include "ResetDialog.hpp"
 #include <QGridLayout>
 #include <QLabel>
+#include <QLineEdit>
 #include <QPushButton>
 #include <QSlider>
 
-ResetDialog::ResetDialog(int presetSize, QWidget * parent)
+static QComboBox * createComboBox(std::vector<std::string> const & items, std::string const & preset, QWidget * parent)
+{
+    QComboBox * box = new QComboBox(parent);
+    for (std::string const & item : items) {
+        box->addItem(QString::fromStdString(item));
+    }
+    box->setCurrentText(QString::fromStdString(preset));
+    return box;
+}
+
+ResetDialog::ResetDialog(int presetSize, std::string const & presetMachine, std::string const & presetWorkload, QWidget * parent)
 : QDialog(parent)
 {
     slider = new QSlider(Qt::Horizontal, this);
     slider->setMinimum(20);
     slider->setMaximum(200);
     slider->setValue(presetSize);
+    machineBox = createComboBox(machineNames(), presetMachine, this);
+    // Editable, so a workload can take a parameter such as runs:12
+    workloadBox = createComboBox(workloadNames(), presetWorkload, this);
+    workloadBox->setEditable(true);
+    workloadBox->setEditText(QString::fromStdString(presetWorkload));
+    workloadBox->setToolTip("nearlysorted:SWAPS, runs:LENGTH or duplicates:VALUES set the workload's parameter");
     QPushButton * button = new QPushButton("Go", this);
     QLabel * sizeLabel = new QLabel(this);
     sizeLabel->setNum(presetSize);
     sizeLabel->setAlignment(Qt::AlignRight);
-    QLabel * instructions = new QLabel("Select tape size:");
+    QLabel * instructions = new QLabel("Select machine, input and tape size:");
     QObject::connect(slider, SIGNAL(valueChanged(int)), sizeLabel, SLOT(setNum(int)));
     QObject::connect(button, SIGNAL(clicked()), this, SLOT(finish()));
     QGridLayout * layout = new QGridLayout(this);
     layout->addWidget(instructions, 0, 0, 1, 3, Qt::AlignLeft);
-    layout->addWidget(sizeLabel, 1, 0, 1, 1);
-    layout->addWidget(slider, 1, 1, 1, 2);
-    layout->addWidget(button, 2, 2, 1, 1);
+    layout->addWidget(machineBox, 1, 0, 1, 2);
+    layout->addWidget(workloadBox, 1, 2, 1, 1);
+    layout->addWidget(sizeLabel, 2, 0, 1, 1);
+    layout->addWidget(slider, 2, 1, 1, 2);
+    layout->addWidget(button, 3, 2, 1, 1);
     layout->setColumnStretch(1, 1);
     setLayout(layout);
 }
@@ -32,8 +52,23 @@ QSize ResetDialog::sizeHint() const
     return QSize(300, 20);
 }
 
+std::string ResetDialog::machine() const
+{
+    return machineBox->currentText().toStdString();
+}
+
+std::string ResetDialog::workload() const
+{
+    return workloadBox->currentText().toStdString();
+}
+
 void ResetDialog::finish()
 {
+    Workload parsed;
+    if (!parseWorkload(workload(), parsed)) {
+        workloadBox->setFocus();
+        workloadBox->lineEdit()->selectAll();
+        return;
+    }
     done(slider->value());
 }
-
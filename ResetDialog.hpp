@@ -1,20 +1,25 @@
 #pragma once
 
 #include <QAbstractSlider>
+#include <QComboBox>
 #include <QDialog>
+#include <string>
 
 class ResetDialog : public QDialog
 {
     Q_OBJECT
 
 public:
-    ResetDialog(int presetSize, QWidget * parent = 0);
+    ResetDialog(int presetSize, std::string const & presetMachine, std::string const & presetWorkload, QWidget * parent = 0);
     virtual QSize sizeHint() const Q_DECL_OVERRIDE;
+    std::string machine() const;
+    std::string workload() const;
 
 public slots:
     void finish();
 
 private:
     QAbstractSlider * slider;
+    QComboBox * machineBox;
+    QComboBox * workloadBox;
 };
-
@@ -0,0 +1,155 @@
+#include "RunTape.hpp"
+#include <algorithm>
+
+RunTape::RunTape()
+: len(0)
+{
+}
+
+void RunTape::assign(int len, QColor const & fill)
+{
+    this->len = len;
+    segments.clear();
+    if (len > 0) {
+        segments.emplace(0, fill);
+    }
+}
+
+void RunTape::assign(std::vector<QColor> const & cells)
+{
+    len = (int)cells.size();
+    segments.clear();
+    for (int i = 0; i < len; ++i) {
+        if (i == 0 || cells[i] != cells[i - 1]) {
+            segments.emplace_hint(segments.end(), i, cells[i]);
+        }
+    }
+}
+
+QColor const & RunTape::get(int i) const
+{
+    return std::prev(segments.upper_bound(i))->second;
+}
+
+void RunTape::set(int i, QColor const & c)
+{
+    fill(i, i + 1, c);
+}
+
+void RunTape::split(int i)
+{
+    if (i <= 0 || i >= len) {
+        return;
+    }
+    auto next = segments.upper_bound(i);
+    auto cur = std::prev(next);
+    if (cur->first != i) {
+        segments.emplace_hint(next, i, cur->second);
+    }
+}
+
+void RunTape::fill(int begin, int end, QColor const & c)
+{
+    if (begin >= end) {
+        return;
+    }
+    split(begin);
+    split(end);
+    auto first = segments.find(begin);
+    auto last = end < len ? segments.find(end) : segments.end();
+    segments.erase(std::next(first), last);
+    first->second = c;
+
+    if (last != segments.end() && last->second == c) {
+        segments.erase(last);
+    }
+    if (first != segments.begin() && std::prev(first)->second == c) {
+        segments.erase(first);
+    }
+}
+
+int RunTape::runBegin(int i) const
+{
+    return std::prev(segments.upper_bound(i))->first;
+}
+
+int RunTape::runEnd(int i) const
+{
+    auto next = segments.upper_bound(i);
+    return next == segments.end() ? len : next->first;
+}
+
+std::vector<QColor> RunTape::toVector() const
+{
+    std::vector<QColor> cells(len);
+    for (auto it = segments.begin(); it != segments.end(); ++it) {
+        auto next = std::next(it);
+        std::fill(cells.begin() + it->first, cells.begin() + (next == segments.end() ? len : next->first), it->second);
+    }
+    return cells;
+}
+
+void Machine::resetRuns(RunTape & tape)
+{
+    std::vector<QColor> cells(tape.size());
+    reset(cells);
+    tape.assign(cells);
+}
+
+long long RunTape::run(Machine & machine, int & pos, long long maxSteps)
+{
+    long long steps = 0;
+    // Finger on the run under the head; the head only ever moves into a
+    // neighbouring run, so it is found again without a search.
+    auto it = std::prev(segments.upper_bound(pos));
+    while (!machine.halted() && steps < maxSteps) {
+        auto next = std::next(it);
+        int begin = it->first;
+        int end = next == segments.end() ? len : next->first;
+        bool repeats;
+        TapeTransition t = machine.advanceRun(it->second, repeats);
+        // If the machine came back unchanged, every cell of the run ahead
+        // of the head gets the same transition.
+        long long n = 1;
+        if (repeats) {
+            n = std::min<long long>(t.dir == RIGHT ? end - pos : pos - begin + 1, maxSteps - steps);
+        }
+        bool changed = t.write != it->second;
+        if (changed) {
+            int first = t.dir == RIGHT ? pos : pos + 1 - (int)n;
+            if (first == begin && first + n == end) {
+                // The whole run changes; only the neighbours can merge into it.
+                it->second = t.write;
+                if (next != segments.end() && next->second == t.write) {
+                    segments.erase(next);
+                }
+                if (it != segments.begin() && std::prev(it)->second == t.write) {
+                    segments.erase(it);
+                }
+            }
+            else {
+                fill(first, first + (int)n, t.write);
+            }
+        }
+        steps += n;
+        if (machine.halted()) {
+            break;
+        }
+        pos = t.dir == RIGHT ? (pos + n) % len : (pos + len - n) % len;
+        if (changed) {
+            it = std::prev(segments.upper_bound(pos));
+        }
+        else if (t.dir == RIGHT && pos == end % len) {
+            it = next == segments.end() ? segments.begin() : next;
+        }
+        else if (t.dir == LEFT && pos == (begin + len - 1) % len) {
+            it = it == segments.begin() ? std::prev(segments.end()) : std::prev(it);
+        }
+    }
+    return steps;
+}
+
+long long run(Machine & machine, RunTape & tape, int & pos, long long maxSteps)
+{
+    return tape.run(machine, pos, maxSteps);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Machine.hpp"
+#include <map>
+#include <vector>
+
+// A circular tape stored as runs of identical symbols, keyed by the first cell
+// of each run. Stepping across a run the machine repeats on costs one
+// operation however long the run is, which pays off for the sieve on long
+// tapes. A run costs about four dense cells of memory, though, and sieving
+// out 2 briefly leaves every cell a run of its own, so peak memory is worse.
+class RunTape
+{
+public:
+    RunTape();
+    void assign(int len, QColor const & fill);
+    void assign(std::vector<QColor> const & cells);
+    int size() const { return len; }
+    int runs() const { return (int)segments.size(); }
+    QColor const & get(int i) const;
+    void set(int i, QColor const & c);
+    // Overwrites cells [begin, end), merging with neighbouring runs of the same symbol.
+    void fill(int begin, int end, QColor const & c);
+    // First cell and one past the last cell of the run containing cell i.
+    int runBegin(int i) const;
+    int runEnd(int i) const;
+    std::vector<QColor> toVector() const;
+    // See the free run() below.
+    long long run(Machine & machine, int & pos, long long maxSteps);
+
+private:
+    void split(int i);
+
+    int len;
+    std::map<int, QColor> segments;
+};
+
+// Steps the machine until it halts or maxSteps have been taken, crossing a
+// whole run in one operation whenever the machine repeats on its symbol.
+// Returns the number of steps taken.
+long long run(Machine & machine, RunTape & tape, int & pos, long long maxSteps);
@@ -1,5 +1,6 @@
 #include "Machine.hpp"
-#include "TuringMachine.hpp"
+#include "PagedTape.hpp"
+#include "RunTape.hpp"
 
 struct Sieve : public Machine
 {
@@ -21,6 +22,11 @@ struct Sieve : public Machine
 
     virtual ~Sieve() {}
 
+    virtual std::unique_ptr<Machine> clone() const
+    {
+        return std::unique_ptr<Sieve>(new Sieve(*this));
+    }
+
     enum Bit {
         MULTIPLE_OR_1 = 1,
         MAYBE_PRIME_OR_1 = 2,
@@ -49,6 +55,12 @@ struct Sieve : public Machine
         state = INIT;
     }
 
+    virtual void resetRuns(RunTape & tape)
+    {
+        tape.assign(tape.size(), Symbol(MAYBE_PRIME_OR_1));
+        state = INIT;
+    }
+
     struct Transition {
         Symbol write;
         Direction dir;
@@ -153,11 +165,42 @@ struct Sieve : public Machine
         }
     }
 
+    // Symbols only take eight values, so their colours are built once
+    static QColor const colors[8];
+
     virtual TapeTransition advance(QColor const & current)
     {
         Transition t = eval(current);
         state = t.nextState;
-        return TapeTransition{ t.write, t.dir };
+        return TapeTransition{ colors[t.write], t.dir };
+    }
+
+    template <class Tape>
+    StepResult advanceTape(Tape & tape, int & pos, long long n)
+    {
+        int tapeLen = tape.size();
+        long long steps = 0;
+        while (state != HALT && steps < n) {
+            Transition t = eval(tape.get(pos));
+            tape.set(pos, colors[t.write]);
+            state = t.nextState;
+            if (state != HALT) {
+                pos = moveHead(pos, t.dir, tapeLen);
+            }
+            ++steps;
+        }
+        return StepResult{ steps, state == HALT };
+    }
+
+    virtual StepResult advanceN(std::vector<QColor> & tape, int & pos, long long n)
+    {
+        DenseTape dense{ tape };
+        return advanceTape(dense, pos, n);
+    }
+
+    virtual StepResult advanceN(PagedTape & tape, int & pos, long long n)
+    {
+        return advanceTape(tape, pos, n);
     }
 
     virtual bool halted() const
@@ -165,7 +208,15 @@ struct Sieve : public Machine
         return state == HALT;
     }
 
-    char const * label() const
+    virtual TapeTransition advanceRun(QColor const & current, bool & repeats)
+    {
+        Transition t = eval(current);
+        repeats = t.nextState == state;
+        state = t.nextState;
+        return TapeTransition{ colors[t.write], t.dir };
+    }
+
+    virtual char const * label() const
     {
         switch (state) {
             default:
@@ -184,24 +235,11 @@ struct Sieve : public Machine
             case HALT: return "H";
         }
     }
-
-    virtual void renderHead(QPainter & painter, TuringMachine const & tm) const
-    {
-        (void)tm;
-        QFont labelFont;
-        qreal fontScale = 7. / QFontMetricsF(labelFont).ascent();
-        labelFont.setPointSizeF(labelFont.pointSizeF() * fontScale);
-
-        painter.save();
-        painter.setFont(labelFont);
-        painter.scale(1. / 4., 1. / 4.);
-        painter.setPen(QPen(Qt::black, 0., Qt::SolidLine));
-        painter.setBrush(Qt::black);
-        painter.drawText(-5, 2, 10, 8, Qt::AlignHCenter, label());
-        painter.restore();
-    }
 };
 
+QColor const Sieve::colors[8] = { Symbol(0), Symbol(1), Symbol(2), Symbol(3),
+                                  Symbol(4), Symbol(5), Symbol(6), Symbol(7) };
+
 std::unique_ptr<Machine> createSieve()
 {
     return std::unique_ptr<Sieve>(new Sieve());
@@ -0,0 +1,219 @@
+#include "HeadRenderer.hpp"
+#include "Simulation.hpp"
+#include <QElapsedTimer>
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+static double const pi = 3.141592653589793238463;
+static qint64 const nsecsPerSec = 1000000000;
+// Steps between checks of the time budget
+static long long const chunk = 4096;
+
+qint64 const Simulation::frameBudget;
+
+Simulation::Simulation(std::unique_ptr<Machine> && machine, int tapeLen)
+: machine(std::move(machine))
+, period(nsecsPerSec)
+{
+    reset(tapeLen);
+}
+
+Simulation::Simulation(Simulation const & other)
+: machine(other.machine->clone())
+, tape(other.tape)
+, pos(other.pos)
+, oldpos(other.oldpos)
+, period(other.period)
+, phase(other.phase)
+, stepCount(other.stepCount)
+{
+}
+
+Simulation & Simulation::operator=(Simulation const & other)
+{
+    machine = other.machine->clone();
+    tape = other.tape;
+    pos = other.pos;
+    oldpos = other.oldpos;
+    period = other.period;
+    phase = other.phase;
+    stepCount = other.stepCount;
+    return *this;
+}
+
+void Simulation::reset(int tapeLen)
+{
+    tape.resize(tapeLen);
+    machine->reset(tape);
+    pos = oldpos = 0;
+    // Start as if the previous step had just finished animating
+    phase = period * 4 / 5;
+    stepCount = 0;
+}
+
+void Simulation::reset(std::unique_ptr<Machine> && machine, int tapeLen)
+{
+    this->machine = std::move(machine);
+    reset(tapeLen);
+}
+
+void Simulation::setRate(double stepsPerSecond)
+{
+    qint64 newPeriod = stepsPerSecond > 0. ? std::max<qint64>(1, qRound64(nsecsPerSec / stepsPerSecond)) : 0;
+    // Keep the same fraction of the current step
+    if (period > 0 && newPeriod > 0) {
+        phase = qint64(double(phase) * newPeriod / period);
+    }
+    else {
+        phase = newPeriod * 4 / 5;
+    }
+    period = newPeriod;
+}
+
+double Simulation::rate() const
+{
+    return period > 0 ? double(nsecsPerSec) / period : 0.;
+}
+
+long long Simulation::steps() const
+{
+    return stepCount;
+}
+
+StepResult Simulation::advanceN(long long n)
+{
+    StepResult result = machine->advanceN(tape, pos, n);
+    stepCount += result.steps;
+    if (period > 0) {
+        phase -= result.steps * period;
+    }
+    return result;
+}
+
+void Simulation::advance(qint64 nsecs, qint64 budget)
+{
+    QElapsedTimer timer;
+    timer.start();
+    if (period == 0) {
+        while (!machine->halted() && timer.nsecsElapsed() < budget) {
+            oldpos = pos;
+            advanceN(chunk);
+        }
+        return;
+    }
+
+    phase += nsecs;
+    if (!machine->halted()) {
+        // Only the last step due is animated; the rest go through in batches.
+        long long backlog = phase / period - 1;
+        while (backlog > 0 && !machine->halted()) {
+            backlog -= advanceN(std::min(backlog, chunk)).steps;
+            if (backlog > 0 && budget > 0 && timer.nsecsElapsed() >= budget) {
+                phase -= backlog * period;
+                backlog = 0;
+            }
+        }
+        if (phase >= period && !machine->halted()) {
+            oldpos = pos;
+            advanceN(1);
+        }
+    }
+    if (machine->halted()) {
+        phase = std::min(phase, period);
+    }
+}
+
+float Simulation::progress() const
+{
+    return period > 0 ? float(double(phase) / period) : 1.f;
+}
+
+bool Simulation::halted() const
+{
+    return machine->halted();
+}
+
+bool Simulation::finished() const
+{
+    return machine->halted() && progress() >= 0.8f;
+}
+
+int Simulation::tapeLength() const
+{
+    return (int)tape.size();
+}
+
+// A tape cell, and the frame the head draws around the cell under it. They
+// never change, and the frame takes a boolean path operation, so both are
+// built once rather than on every frame of every instance.
+static QPainterPath const & cellPath()
+{
+    static QPainterPath const box = []() {
+        QPainterPath path;
+        path.addRect(-.5, -1., 1., 1.);
+        return path;
+    }();
+    return box;
+}
+
+static QPainterPath const & windowPath()
+{
+    static QPainterPath const window = []() {
+        QPainterPath path;
+        path.addRect(-.7, -1.2, 1.4, 1.4);
+        return path.subtracted(cellPath());
+    }();
+    return window;
+}
+
+void Simulation::render(QPainter & painter, int dimension, bool fixTape) const
+{
+    float progress = this->progress();
+    qreal rBegin = 360. * oldpos / tape.size();
+    int delta = (pos - oldpos + tape.size() + 1) % tape.size() - 1;
+    qreal rDelta = 360. * delta / tape.size();
+    qreal interp;
+    if (progress < 0.2)
+        interp = 0.;
+    else if (progress < 0.8)
+        interp = (1. - cos((progress - 0.2) * pi / 0.6)) / 2.;
+    else
+        interp = 1.;
+    qreal tapeRot = rBegin + rDelta * interp;
+
+    qreal innerRadius = 1.12 * tape.size() / (2. * pi) + 1.2;
+    qreal boundRadius = innerRadius + 1.2;
+    QPainterPath const & box = cellPath();
+    QPainterPath const & window = windowPath();
+
+    painter.save();
+    painter.scale(dimension / (2. * boundRadius), dimension / (2. * boundRadius));
+    painter.translate(boundRadius, boundRadius);
+    painter.setPen(QPen(Qt::black, 0.05, Qt::SolidLine, Qt::SquareCap, Qt::MiterJoin));
+
+    painter.save();
+    if (!fixTape)
+        painter.rotate(-tapeRot);
+    for (int i = 0; i < (int)tape.size(); ++i) {
+        painter.setBrush(tape[i]);
+        painter.translate(0., -innerRadius);
+        painter.drawPath(box);
+        painter.translate(0., innerRadius);
+        painter.rotate(360. / tape.size());
+    }
+    painter.restore();
+
+    if (fixTape)
+        painter.rotate(tapeRot);
+    painter.translate(0., -innerRadius);
+
+    painter.save();
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Qt::darkGray);
+    painter.drawPath(window);
+    painter.restore();
+    renderHead(*machine, painter);
+    painter.restore();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Machine.hpp"
+#include <QtGlobal>
+#include <memory>
+#include <vector>
+
+class QPainter;
+
+// A machine on a circular tape, paced in wall-clock time and drawn as a ring.
+// TuringMachine shows one of these; Dashboard shows many in one paint pass.
+// Pacing is kept in integer nanoseconds, so over any stretch of time the
+// number of steps taken is exactly the elapsed time over the step period.
+class Simulation
+{
+public:
+    Simulation(std::unique_ptr<Machine> && machine, int tapeLen);
+    Simulation(Simulation const & other);
+    Simulation & operator=(Simulation const & other);
+    void reset(int tapeLen);
+    void reset(std::unique_ptr<Machine> && machine, int tapeLen);
+    // Steps per second, or zero to run as fast as the time budget allows.
+    void setRate(double stepsPerSecond);
+    double rate() const;
+    // Takes whatever steps are due after nsecs more nanoseconds. If that
+    // would take longer than budget nanoseconds of real time, the backlog is
+    // dropped and shows up as a lower achieved rate; a budget of zero or
+    // less never drops steps. At unlimited rate this steps for the budget.
+    void advance(qint64 nsecs, qint64 budget = frameBudget);
+    // Steps taken since the last reset.
+    long long steps() const;
+    bool halted() const;
+    // Halted, and the last step has finished animating.
+    bool finished() const;
+    int tapeLength() const;
+
+    static qint64 const frameBudget = 8000000;
+    // Draws the tape and head centred in a dimension x dimension square at the origin.
+    void render(QPainter & painter, int dimension, bool fixTape) const;
+
+private:
+    std::unique_ptr<Machine> machine;
+    std::vector<QColor> tape;
+    int pos;
+    int oldpos;
+    // Nanoseconds per step, or zero for unlimited; phase is the time spent
+    // so far in the current step, so progress through it is phase / period.
+    qint64 period;
+    qint64 phase;
+    long long stepCount;
+
+    StepResult advanceN(long long n);
+    float progress() const;
+};
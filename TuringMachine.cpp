@@ -2,21 +2,18 @@
 #include <QPainter>
 #include <algorithm>
 #include <cmath>
-#include <random>
 #include <utility>
 
-double const pi = 3.141592653589793238463;
-std::mt19937 rng;
+// Shortest stretch over which the achieved rate is measured
+static qint64 const rateWindow = 500000000;
 
 TuringMachine::TuringMachine(std::unique_ptr<Machine> && machine, int tapeLen, QWidget * parent)
 : QWidget(parent)
-, machine(std::move(machine))
-, speed(1024.)
+, sim(std::move(machine), tapeLen)
+, started(false)
 , paused(false)
 , fixTape(false)
 {
-    rng.seed(time.msecsSinceStartOfDay());
-    reset(tapeLen);
     time.start();
 }
 
@@ -25,13 +22,18 @@ QSize TuringMachine::sizeHint() const
     return QSize(500, 500);
 }
 
-void TuringMachine::setSpeed(int milliLogMsecs)
+double TuringMachine::stepsPerSecond(int milliLogRate)
 {
-    if (milliLogMsecs == 11000) {
+    return milliLogRate >= rateUnlimited ? 0. : pow(2., (std::max(milliLogRate, 1) - 1) / 1000.);
+}
+
+void TuringMachine::setRate(int milliLogRate)
+{
+    if (milliLogRate <= 0) {
         pause();
     }
     else {
-        speed = pow(2., milliLogMsecs / 1000.);
+        sim.setRate(stepsPerSecond(milliLogRate));
         unpause();
     }
 }
@@ -47,113 +49,59 @@ bool TuringMachine::unpause()
 {
     bool wasPaused = paused;
     paused = false;
-    oldtime = time.elapsed();
+    oldtime = time.nsecsElapsed();
+    restartRateWindow(oldtime);
     update();
     return wasPaused;
 }
 
 void TuringMachine::reset(int tapeLen)
 {
-    tape.resize(tapeLen);
-    machine->reset(tape);
-    pos = oldpos = 0;
+    sim.reset(tapeLen);
     started = false;
 }
 
-void TuringMachine::setFixTape(int fixTape)
+void TuringMachine::reset(std::unique_ptr<Machine> && machine, int tapeLen)
 {
-    this->fixTape = fixTape;
-    update();
+    sim.reset(std::move(machine), tapeLen);
+    started = false;
 }
 
-void TuringMachine::renderBox(QPainter & painter, QColor const & fill) const
+void TuringMachine::restartRateWindow(qint64 curtime)
+{
+    rateTime = curtime;
+    rateSteps = sim.steps();
+}
+
+void TuringMachine::setFixTape(int fixTape)
 {
-    QPainterPath box;
-    box.addRect(-.5, -1., 1., 1.);
-    painter.save();
-    painter.setPen(QPen(Qt::black, 0.05, Qt::SolidLine, Qt::SquareCap, Qt::MiterJoin));
-    painter.setBrush(fill);
-    painter.drawPath(box);
-    painter.restore();
+    this->fixTape = fixTape;
+    update();
 }
 
 void TuringMachine::paintEvent(QPaintEvent * event)
 {
     (void)event;
     if (!paused) {
-        int curtime = time.elapsed();
+        qint64 curtime = time.nsecsElapsed();
         if (!started) {
-            oldpos = pos;
-            progress = 0.8;
             oldtime = curtime;
+            restartRateWindow(curtime);
             started = true;
         }
-        progress += float(curtime - oldtime) / speed;
+        sim.advance(curtime - oldtime);
         oldtime = curtime;
-    }
-
-    while (!machine->halted()  && progress >= 1.) {
-        oldpos = pos;
-        TapeTransition t = machine->advance(tape[pos]);
-        tape[pos] = t.write;
-        if (!machine->halted()) {
-            pos = (pos + (t.dir == LEFT ? tape.size() - 1 : 1)) % tape.size();
+        if (curtime - rateTime >= rateWindow && !sim.halted()) {
+            emit rateChanged(sim.rate(), (sim.steps() - rateSteps) * 1e9 / (curtime - rateTime));
+            restartRateWindow(curtime);
         }
-        progress -= 1.;
     }
 
-    qreal rBegin = 360. * oldpos / tape.size();
-    int delta = (pos - oldpos + tape.size() + 1) % tape.size() - 1;
-    qreal rDelta = 360. * delta / tape.size();
-    qreal interp;
-    if (progress < 0.2)
-        interp = 0.;
-    else if (progress < 0.8)
-        interp = (1. - cos((progress - 0.2) * pi / 0.6)) / 2.;
-    else
-        interp = 1.;
-    qreal tapeRot = rBegin + rDelta * interp;
-
-    qreal innerRadius = 1.12 * tape.size() / (2. * pi) + 1.2;
-    qreal boundRadius = innerRadius + 1.2;
-    QPainterPath box;
-    box.addRect(-.5, -1., 1., 1.);
-    QPainterPath window;
-    window.addRect(-.7, -1.2, 1.4, 1.4);
-    window = window.subtracted(box);
-
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
-    int dimension = std::min(width(), height());
-    painter.scale(dimension / (2. * boundRadius), dimension / (2. * boundRadius));
-    painter.translate(boundRadius, boundRadius);
-    painter.setPen(QPen(Qt::black, 0.05, Qt::SolidLine, Qt::SquareCap, Qt::MiterJoin));
+    sim.render(painter, std::min(width(), height()), fixTape);
 
-    painter.save();
-    if (!fixTape)
-        painter.rotate(-tapeRot);
-    for (int i = 0; i < (int)tape.size(); ++i) {
-        painter.setBrush(tape[i]);
-        painter.translate(0., -innerRadius);
-        painter.drawPath(box);
-        painter.translate(0., innerRadius);
-        painter.rotate(360. / tape.size());
-    }
-    painter.restore();
-
-    if (fixTape)
-        painter.rotate(tapeRot);
-    painter.translate(0., -innerRadius);
-
-    painter.save();
-    painter.setPen(Qt::NoPen);
-    painter.setBrush(Qt::darkGray);
-    painter.drawPath(window);
-    painter.restore();
-    machine->renderHead(painter, *this);
-
-    if (!paused && !machine->halted()) {
+    if (!paused && !sim.halted()) {
         update();
     }
 }
-
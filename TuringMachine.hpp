@@ -1,13 +1,9 @@
 #pragma once
 
-#include "Machine.hpp"
-#include <QTime>
+#include "Simulation.hpp"
+#include <QElapsedTimer>
 #include <QWidget>
 #include <memory>
-#include <random>
-#include <vector>
-
-extern std::mt19937 rng;
 
 class TuringMachine : public QWidget
 {
@@ -19,10 +15,20 @@ public:
     bool pause();
     bool unpause();
     QSize sizeHint() const Q_DECL_OVERRIDE;
-    void renderBox(QPainter & painter, QColor const & fill) const;
+    void reset(std::unique_ptr<Machine> && machine, int tapeLen);
+
+    static int const rateUnlimited = 21000;
+    // Steps per second for a slider value: 2^((milliLogRate - 1) / 1000), so
+    // the lowest running value is 1 step/s; 0 for rateUnlimited.
+    static double stepsPerSecond(int milliLogRate);
+
+signals:
+    // Requested steps per second (zero for unlimited) and the rate actually achieved
+    void rateChanged(double requested, double achieved);
 
 public slots:
-    void setSpeed(int milliLogMsecs);
+    // See stepsPerSecond; 0 pauses and rateUnlimited runs flat out.
+    void setRate(int milliLogRate);
     void reset(int tapeLen);
     void setFixTape(int fixTape);
 
@@ -30,17 +36,15 @@ protected:
     void paintEvent(QPaintEvent * event) Q_DECL_OVERRIDE;
 
 private:
-    std::unique_ptr<Machine> machine;
-    std::vector<QColor> tape;
-    int pos;
+    void restartRateWindow(qint64 curtime);
 
-    QTime time;
-    float speed;
+    Simulation sim;
+
+    QElapsedTimer time;
     bool started;
     bool paused;
-    int oldpos;
-    int oldtime;
-    float progress;
+    qint64 oldtime;
     bool fixTape;
+    qint64 rateTime;
+    long long rateSteps;
 };
-
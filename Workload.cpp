@@ -0,0 +1,153 @@
+#include "Machine.hpp"
+#include "Workload.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+static char const * const names[] = { "uniform", "nearlysorted", "runs", "duplicates", "reversed", "sawtooth" };
+// Largest parameter each kind takes, or 0 if it takes none
+static int const maxParameters[] = { 0, INT_MAX, INT_MAX, maxDistinctHues, 0, 0 };
+static int const distinctDuplicates = 8;
+
+bool parseWorkload(std::string const & spec, Workload & workload)
+{
+    std::string::size_type colon = spec.find(':');
+    std::string name = spec.substr(0, colon);
+    for (int i = 0; i < int(sizeof(names) / sizeof(names[0])); ++i) {
+        if (name != names[i])
+            continue;
+        Workload parsed((WorkloadKind)i);
+        if (colon != std::string::npos) {
+            std::string value = spec.substr(colon + 1);
+            char * end = nullptr;
+            errno = 0;
+            long parameter = strtol(value.c_str(), &end, 10);
+            if (value.empty() || !isdigit((unsigned char)value[0]) || *end || errno != 0
+                || parameter < 1 || parameter > maxParameters[i])
+                return false;
+            parsed.parameter = (int)parameter;
+        }
+        workload = parsed;
+        return true;
+    }
+    return false;
+}
+
+std::string workloadName(Workload const & workload)
+{
+    std::string name = names[workload.kind];
+    if (workload.parameter > 0)
+        name += ":" + std::to_string(workload.parameter);
+    return name;
+}
+
+std::vector<std::string> workloadNames()
+{
+    return std::vector<std::string>(std::begin(names), std::end(names));
+}
+
+static QColor hue(qreal h)
+{
+    return QColor::fromHslF(h, .9, .5);
+}
+
+void fillWorkload(std::vector<QColor> & tape, Workload const & workload)
+{
+    int len = (int)tape.size();
+    if (len == 0)
+        return;
+    int root = std::max(2, (int)std::sqrt(double(len)));
+    switch (workload.kind) {
+        default:
+        case UNIFORM:
+            for (int i = 0; i < len; ++i) {
+                tape[i] = hue(qreal(i) / len);
+            }
+            std::shuffle(tape.begin(), tape.end(), rng);
+            break;
+
+        case NEARLY_SORTED: {
+            for (int i = 0; i < len; ++i) {
+                tape[i] = hue(qreal(i) / len);
+            }
+            std::uniform_int_distribution<int> cell(0, len - 1);
+            std::uniform_int_distribution<int> offset(1, 8);
+            for (int k = workload.parameter > 0 ? workload.parameter : std::max(1, len / 100); k > 0; --k) {
+                int a = cell(rng);
+                int b = std::min(len - 1, a + offset(rng));
+                std::swap(tape[a], tape[b]);
+            }
+            break;
+        }
+
+        case RUNS: {
+            if (workload.parameter > 0)
+                root = std::min(workload.parameter, len);
+            int runs = (len + root - 1) / root;
+            std::vector<int> order(runs);
+            for (int r = 0; r < runs; ++r) {
+                order[r] = r;
+            }
+            std::shuffle(order.begin(), order.end(), rng);
+            // Hue is the cell's rank in sorted order over len, so hues stay a
+            // whole step apart; only the last run is shorter than root.
+            int shortfall = runs * root - len;
+            for (int i = 0; i < len; ++i) {
+                int o = order[i / root];
+                int start = o * root - (o > order[runs - 1] ? shortfall : 0);
+                tape[i] = hue(qreal(start + i % root) / len);
+            }
+            break;
+        }
+
+        case DUPLICATES: {
+            // Each cell sits one hue step past the previous cell of its
+            // cluster, so the clusters' sizes have to be counted first.
+            int clusters = workload.parameter > 0 ? workload.parameter : distinctDuplicates;
+            std::uniform_int_distribution<int> value(0, clusters - 1);
+            std::vector<int> cluster(len);
+            std::vector<int> first(clusters, 0);
+            for (int i = 0; i < len; ++i) {
+                cluster[i] = value(rng);
+                ++first[cluster[i]];
+            }
+            // Clusters start evenly spread, pushed along if the one before
+            // overflows its share of the hue circle, and pulled back if the
+            // ones after would otherwise run past the end of it.
+            int next = 0;
+            int remaining = len;
+            for (int v = 0; v < clusters; ++v) {
+                int count = first[v];
+                next = std::max(next, std::min(v * maxDistinctHues / clusters, maxDistinctHues - remaining));
+                first[v] = next;
+                next += count;
+                remaining -= count;
+            }
+            for (int i = 0; i < len; ++i) {
+                tape[i] = hue(qreal(first[cluster[i]]++ % maxDistinctHues) / maxDistinctHues);
+            }
+            break;
+        }
+
+        case REVERSED:
+            for (int i = 0; i < len; ++i) {
+                tape[i] = hue(qreal(len - 1 - i) / len);
+            }
+            break;
+
+        case SAWTOOTH: {
+            // Sorted order is by column i % root, then by tooth; the first
+            // len % root columns have one cell more than the rest.
+            int full = len / root;
+            int extra = len % root;
+            for (int i = 0; i < len; ++i) {
+                int column = i % root;
+                tape[i] = hue(qreal(column * full + std::min(column, extra) + i / root) / len);
+            }
+            break;
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QColor>
+#include <string>
+#include <vector>
+
+// Input distributions for the sorting machines. Each fills the tape with
+// hues; the sorting machines order them cyclically by hue. That comparison
+// cannot tell equal hues apart, and a sorter given two equal hues may never
+// halt, so every workload keeps hues distinct. QColor stores hue in
+// hundredths of a degree, so that only works on tapes of up to
+// maxDistinctHues cells.
+enum WorkloadKind {
+    UNIFORM,        // random permutation of distinct hues
+    NEARLY_SORTED,  // sorted, then K cells (default 1%) swapped with a cell up to 8 along
+    RUNS,           // ascending runs of LEN cells (default sqrt(n)), in random order
+    DUPLICATES,     // hues bunched one hue step apart around N values (default 8)
+    REVERSED,       // strictly descending
+    SAWTOOTH        // about sqrt(n) interleaved ascending ramps
+};
+
+// A workload kind and its parameter, written NAME or NAME:PARAMETER, e.g.
+// nearlysorted:K, runs:LEN or duplicates:N. A parameter of 0 means the
+// kind's default.
+struct Workload
+{
+    WorkloadKind kind;
+    int parameter;
+
+    Workload(WorkloadKind kind = UNIFORM, int parameter = 0)
+    : kind(kind)
+    , parameter(parameter)
+    {
+    }
+};
+
+int const maxDistinctHues = 36000;
+
+// Parses NAME or NAME:PARAMETER; fails on unknown names, on a parameter for
+// a kind that takes none, and on parameters that aren't positive integers.
+bool parseWorkload(std::string const & spec, Workload & workload);
+std::string workloadName(Workload const & workload);
+std::vector<std::string> workloadNames();
+
+// Fills the tape for the given workload, drawing from rng.
+void fillWorkload(std::vector<QColor> & tape, Workload const & workload);
@@ -0,0 +1,329 @@
+#include "Explorer.hpp"
+#include "Machine.hpp"
+#include "PagedTape.hpp"
+#include "PerfCounters.hpp"
+#include "RunTape.hpp"
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+// Headless runner: steps machines without any widgets and prints one JSON
+// object per run, so it can be driven from scripts and job schedulers.
+
+static char const * usage =
+    "Usage: turingmachine-batch [options]\n"
+    "  --machine=NAME[,NAME...]  machines to run (default sieve)\n"
+    "  --length=N[,N...]         tape lengths (default 40)\n"
+    "  --seed=S                  random seed (default derived from the clock)\n"
+    "  --steps=N                 step limit per run (default unlimited)\n"
+    "  --tape=dense|runs         tape representation (default dense)\n"
+    "  --workload=NAME[:P]       input for the sorting machines (default uniform):\n"
+    "                            uniform, nearlysorted[:SWAPS], runs[:LENGTH],\n"
+    "                            duplicates[:VALUES], reversed, sawtooth\n"
+    "  --perf                    report hardware counters per million steps (Linux)\n"
+    "  --forks=N                 after --fork-at steps, swap two random cells in each of N\n"
+    "                            copy-on-write forks and run them all in parallel;\n"
+    "                            not with --tape=runs, --perf or --explore\n"
+    "  --fork-at=K               step at which to fork (default 0; needs --forks)\n"
+    "  --explore=bfs|best        search the nondeterministic marker search machine instead\n"
+    "  --budget=MB               memory budget for --explore (default 1024)\n"
+    "  --frontier=KB             breadth-first frontier kept in memory before it spills\n"
+    "                            to disk, out of the budget (default budget/8, at most 1024)\n";
+
+static std::vector<std::string> split(std::string const & list)
+{
+    std::vector<std::string> items;
+    std::istringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty())
+            items.push_back(item);
+    }
+    return items;
+}
+
+static bool option(char const * arg, char const * name, std::string & value)
+{
+    size_t len = strlen(name);
+    if (strncmp(arg, name, len) != 0 || arg[len] != '=')
+        return false;
+    value = arg + len + 1;
+    return true;
+}
+
+// Parses a whole decimal integer within [min, max]; false for anything else.
+static bool parseInteger(std::string const & value, long long min, long long max, long long & out)
+{
+    char * end;
+    errno = 0;
+    out = strtoll(value.c_str(), &end, 10);
+    return !value.empty() && !*end && errno == 0 && out >= min && out <= max;
+}
+
+template <class Tape>
+static long long timedRun(Machine & machine, Tape & tape, int & pos, long long maxSteps,
+                          double & seconds, PerfCounters * perf)
+{
+    auto start = std::chrono::steady_clock::now();
+    if (perf)
+        perf->start();
+    long long steps = run(machine, tape, pos, maxSteps);
+    if (perf)
+        perf->stop();
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return steps;
+}
+
+static void printPerf(PerfCounters const & perf, long long steps)
+{
+    double perMStep = steps ? 1e6 / steps : 0.;
+    printf(",\"perf\":{");
+    for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+        PerfCounters::Event event = PerfCounters::Event(e);
+        printf("%s\"%s_per_mstep\":", e ? "," : "", PerfCounters::name(event));
+        if (perf.measured(event))
+            printf("%.1f", perf.count(event) * perMStep);
+        else
+            printf("null");
+    }
+    printf(",\"ipc\":");
+    if (perf.measured(PerfCounters::CYCLES) && perf.measured(PerfCounters::INSTRUCTIONS) && perf.count(PerfCounters::CYCLES) > 0.)
+        printf("%.3f", perf.count(PerfCounters::INSTRUCTIONS) / perf.count(PerfCounters::CYCLES));
+    else
+        printf("null");
+    printf("}");
+}
+
+// Runs one machine to forkAt on a paged tape, then forks it, perturbs each
+// fork and continues them in parallel, printing one line per fork.
+static void forkRun(std::string const & name, Workload workload, int len, unsigned seed,
+                    long long forkAt, int forks, long long maxSteps)
+{
+    rng.seed(seed);
+    Branch trunk{ createMachine(name, workload), PagedTape(), 0, 0 };
+    std::vector<QColor> cells(len);
+    trunk.machine->reset(cells);
+    trunk.tape.assign(cells);
+    trunk.steps = run(*trunk.machine, trunk.tape, trunk.pos, std::min(forkAt, maxSteps));
+
+    std::vector<Branch> branches;
+    std::uniform_int_distribution<int> cell(0, len - 1);
+    for (int i = 0; i < forks; ++i) {
+        branches.push_back(trunk.fork());
+        int a = cell(rng);
+        int b = cell(rng);
+        QColor swapped = branches.back().tape.get(a);
+        branches.back().tape.set(a, branches.back().tape.get(b));
+        branches.back().tape.set(b, swapped);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    runBranches(branches, maxSteps - trunk.steps);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (int i = 0; i < forks; ++i) {
+        Branch const & branch = branches[i];
+        printf("{\"machine\":\"%s\",\"workload\":\"%s\",\"length\":%d,\"seed\":%u,\"tape\":\"paged\",\"fork_at\":%lld,\"fork\":%d,"
+               "\"steps\":%lld,\"halted\":%s,\"pos\":%d,\"private_pages\":%d,\"pages\":%d,\"seconds\":%.6f}\n",
+               name.c_str(), workloadName(workload).c_str(), len, seed, trunk.steps, i,
+               branch.steps, branch.machine->halted() ? "true" : "false", branch.pos,
+               branch.tape.privatePages(), branch.tape.pageCount(), seconds);
+    }
+}
+
+static void exploreRun(int len, ExploreSettings const & settings)
+{
+    std::unique_ptr<NondeterministicMachine> machine = createMarkerSearch();
+    Explorer explorer(*machine, len, settings);
+    auto start = std::chrono::steady_clock::now();
+    ExploreResult result = explorer.explore();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("{\"machine\":\"markersearch\",\"length\":%d,\"search\":\"%s\",\"configurations\":%lld,\"duplicates\":%lld,"
+           "\"spilled\":%lld,\"depth\":%d,\"accepted\":%s,\"budget_exceeded\":%s,\"seconds\":%.6f}\n",
+           len, settings.bestFirst ? "best" : "bfs", result.configurations, result.duplicates,
+           result.spilled, result.depth, result.accepted >= 0 ? "true" : "false",
+           result.budgetExceeded ? "true" : "false", seconds);
+}
+
+int main(int argc, char ** argv)
+{
+    std::vector<std::string> machines = { "sieve" };
+    std::vector<int> lengths = { 40 };
+    unsigned seed = (unsigned)std::chrono::system_clock::now().time_since_epoch().count();
+    long long maxSteps = LLONG_MAX;
+    bool runTape = false;
+    bool profile = false;
+    Workload workload = UNIFORM;
+    int forks = 0;
+    long long forkAt = 0;
+    bool forkAtGiven = false;
+    bool explore = false;
+    ExploreSettings exploreSettings = { false, size_t(1024) << 20, 0, 0 };
+
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        if (option(argv[i], "--machine", value)) {
+            machines = split(value);
+        }
+        else if (option(argv[i], "--length", value)) {
+            lengths.clear();
+            for (std::string const & len : split(value)) {
+                long long parsed;
+                if (!parseInteger(len, 1, INT_MAX, parsed)) {
+                    fprintf(stderr, "Invalid tape length '%s'\n", len.c_str());
+                    return 1;
+                }
+                lengths.push_back((int)parsed);
+            }
+        }
+        else if (option(argv[i], "--seed", value)) {
+            long long parsed;
+            if (!parseInteger(value, 0, UINT_MAX, parsed)) {
+                fprintf(stderr, "Invalid seed '%s'\n", value.c_str());
+                return 1;
+            }
+            seed = (unsigned)parsed;
+        }
+        else if (option(argv[i], "--steps", value)) {
+            if (!parseInteger(value, 0, LLONG_MAX, maxSteps)) {
+                fprintf(stderr, "Invalid step limit '%s'\n", value.c_str());
+                return 1;
+            }
+        }
+        else if (option(argv[i], "--tape", value) && (value == "dense" || value == "runs")) {
+            runTape = value == "runs";
+        }
+        else if (option(argv[i], "--workload", value)) {
+            if (!parseWorkload(value, workload)) {
+                fprintf(stderr, "Invalid workload '%s'\n", value.c_str());
+                return 1;
+            }
+        }
+        else if (option(argv[i], "--forks", value)) {
+            long long parsed;
+            if (!parseInteger(value, 1, INT_MAX, parsed)) {
+                fprintf(stderr, "Invalid fork count '%s'\n", value.c_str());
+                return 1;
+            }
+            forks = (int)parsed;
+        }
+        else if (option(argv[i], "--fork-at", value)) {
+            if (!parseInteger(value, 0, LLONG_MAX, forkAt)) {
+                fprintf(stderr, "Invalid fork step '%s'\n", value.c_str());
+                return 1;
+            }
+            forkAtGiven = true;
+        }
+        else if (option(argv[i], "--explore", value) && (value == "bfs" || value == "best")) {
+            explore = true;
+            exploreSettings.bestFirst = value == "best";
+        }
+        else if (option(argv[i], "--budget", value)) {
+            long long megabytes;
+            if (!parseInteger(value, 1, (long long)(SIZE_MAX >> 20), megabytes)) {
+                fprintf(stderr, "Invalid memory budget '%s'\n", value.c_str());
+                return 1;
+            }
+            exploreSettings.memoryBudget = size_t(megabytes) << 20;
+        }
+        else if (option(argv[i], "--frontier", value)) {
+            long long kilobytes;
+            if (!parseInteger(value, 1, (long long)(SIZE_MAX >> 10), kilobytes)) {
+                fprintf(stderr, "Invalid frontier memory '%s'\n", value.c_str());
+                return 1;
+            }
+            exploreSettings.frontierMemory = size_t(kilobytes) << 10;
+        }
+        else if (strcmp(argv[i], "--perf") == 0) {
+            profile = true;
+        }
+        else {
+            fputs(usage, strcmp(argv[i], "--help") ? stderr : stdout);
+            return strcmp(argv[i], "--help") ? 1 : 0;
+        }
+    }
+
+    // Forks always run on paged tapes and are timed as a group
+    if (forks > 0 && (runTape || profile || explore)) {
+        fprintf(stderr, "--forks cannot be combined with --tape=runs, --perf or --explore\n");
+        return 1;
+    }
+    if (forkAtGiven && forks == 0) {
+        fprintf(stderr, "--fork-at needs --forks\n");
+        return 1;
+    }
+
+    for (std::string const & name : machines) {
+        if (!createMachine(name)) {
+            fprintf(stderr, "Unknown machine '%s'\n", name.c_str());
+            return 1;
+        }
+    }
+    for (int len : lengths) {
+        for (std::string const & name : machines) {
+            if (!explore && (len < minimumLength(name) || len > maximumLength(name))) {
+                fprintf(stderr, "Machine '%s' needs a tape of %d to %d cells\n", name.c_str(), minimumLength(name), maximumLength(name));
+                return 1;
+            }
+        }
+    }
+
+    if (explore) {
+        if (exploreSettings.frontierMemory >= exploreSettings.memoryBudget) {
+            fprintf(stderr, "--frontier must be smaller than --budget\n");
+            return 1;
+        }
+        for (int len : lengths)
+            exploreRun(len, exploreSettings);
+        return 0;
+    }
+
+    std::unique_ptr<PerfCounters> perf;
+    if (profile) {
+        perf.reset(new PerfCounters());
+        if (!perf->anyAvailable())
+            fprintf(stderr, "Hardware counters are unavailable; check perf_event_paranoid\n");
+    }
+
+    for (std::string const & name : machines) {
+        for (int len : lengths) {
+            if (forks > 0) {
+                forkRun(name, workload, len, seed, forkAt, forks, maxSteps);
+                continue;
+            }
+            std::unique_ptr<Machine> machine = createMachine(name, workload);
+            rng.seed(seed);
+            int pos = 0;
+            long long steps;
+            int runs = 0;
+            double seconds;
+            if (runTape) {
+                RunTape tape;
+                tape.assign(len, Qt::black);
+                machine->resetRuns(tape);
+                steps = timedRun(*machine, tape, pos, maxSteps, seconds, perf.get());
+                runs = tape.runs();
+            }
+            else {
+                std::vector<QColor> tape(len);
+                machine->reset(tape);
+                steps = timedRun(*machine, tape, pos, maxSteps, seconds, perf.get());
+            }
+            printf("{\"machine\":\"%s\",\"workload\":\"%s\",\"length\":%d,\"seed\":%u,\"tape\":\"%s\",\"steps\":%lld,\"halted\":%s,\"pos\":%d",
+                   name.c_str(), workloadName(workload).c_str(), len, seed, runTape ? "runs" : "dense", steps,
+                   machine->halted() ? "true" : "false", pos);
+            if (runTape)
+                printf(",\"runs\":%d", runs);
+            printf(",\"seconds\":%.6f", seconds);
+            if (perf)
+                printPerf(*perf, steps);
+            printf("}\n");
+        }
+    }
+    return 0;
+}
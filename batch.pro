@@ -0,0 +1,20 @@
+# Headless batch runner: qmake batch.pro && make -f Makefile.batch
+# Only QtGui is linked, for QColor; no widgets or platform plugin are loaded.
+TEMPLATE = app
+TARGET = turingmachine-batch
+QT = core gui
+CONFIG += qt console
+CONFIG -= app_bundle
+#CONFIG += debug
+MAKEFILE = Makefile.batch
+OBJECTS_DIR = .obj-batch
+
+include(common.pri)
+
+# Input
+HEADERS += Explorer.hpp
+HEADERS += PerfCounters.hpp
+
+SOURCES += batch.cpp
+SOURCES += Explorer.cpp
+SOURCES += PerfCounters.cpp
@@ -0,0 +1,18 @@
+# Machines and the stepping engine, shared by the GUI and batch targets. They
+# use QtGui only for QColor; drawing them lives in the GUI target.
+QMAKE_CXXFLAGS += -std=c++11 -stdlib=libc++
+QMAKE_LFLAGS += -stdlib=libc++
+CONFIG += thread
+
+HEADERS += $$PWD/Machine.hpp
+HEADERS += $$PWD/PagedTape.hpp
+HEADERS += $$PWD/RunTape.hpp
+HEADERS += $$PWD/Workload.hpp
+
+SOURCES += $$PWD/InsertionSort.cpp
+SOURCES += $$PWD/Machine.cpp
+SOURCES += $$PWD/MergeSort.cpp
+SOURCES += $$PWD/PagedTape.cpp
+SOURCES += $$PWD/RunTape.cpp
+SOURCES += $$PWD/Sieve.cpp
+SOURCES += $$PWD/Workload.cpp
@@ -1,14 +1,118 @@
+#include "DashboardWidget.hpp"
+#include "Exporter.hpp"
 #include "MainWidget.hpp"
 #include <QApplication>
+#include <QGuiApplication>
 #include <QMainWindow>
+#include <QTime>
+#include <QTimer>
+#include <cstdio>
+#include <cstring>
+
+// Value of a --name=value argument, or the fallback if it wasn't given
+static QString option(QStringList const & args, QString const & name, QString const & fallback = QString())
+{
+    QString value = fallback;
+    for (QString const & arg : args) {
+        if (arg.startsWith("--" + name + "="))
+            value = arg.section('=', 1);
+    }
+    return value;
+}
+
+// Renders a run to images for --export=PATTERN. Only QImage and QPainter are
+// used, so this runs on the offscreen platform and needs no display.
+static int exportMain(QStringList const & args)
+{
+    QString output = option(args, "export");
+    Workload workload;
+    QString workloadSpec = option(args, "workload", "uniform");
+    if (!parseWorkload(workloadSpec.toStdString(), workload)) {
+        fprintf(stderr, "Invalid workload '%s'\n", qPrintable(workloadSpec));
+        return 1;
+    }
+    std::string name = option(args, "machine", "sieve").toStdString();
+    std::unique_ptr<Machine> machine = createMachine(name, workload);
+    if (!machine) {
+        fprintf(stderr, "Unknown machine\n");
+        return 1;
+    }
+    bool lengthOk;
+    int length = option(args, "length", "40").toInt(&lengthOk);
+    if (!lengthOk || length < minimumLength(name) || length > maximumLength(name)) {
+        fprintf(stderr, "Tape length must be from %d to %d for %s\n", minimumLength(name), maximumLength(name), name.c_str());
+        return 1;
+    }
+    if (!isFramePattern(output)) {
+        fprintf(stderr, "Export pattern needs exactly one %%d for the frame number\n");
+        return 1;
+    }
+    ExportSettings settings;
+    settings.output = output;
+    settings.frames = option(args, "frames", "1000").toInt();
+    settings.size = option(args, "frame-size", "500").toInt();
+    settings.stepsPerFrame = option(args, "steps-per-frame", "0.25").toDouble();
+    settings.fixTape = args.contains("--fix-tape");
+    if (settings.size <= 0 || settings.stepsPerFrame <= 0.) {
+        fprintf(stderr, "Frame size and steps per frame must be positive\n");
+        return 1;
+    }
+    int written = exportFrames(Simulation(std::move(machine), length), settings);
+    if (written < 0) {
+        fprintf(stderr, "Failed to write frames to %s\n", qPrintable(output));
+        return 1;
+    }
+    fprintf(stderr, "Wrote %d frames\n", written);
+    return 0;
+}
+
+// True if the command line asks for --export, checked before any application
+// object exists so the export path never opens a display connection
+static bool wantsExport(int argc, char ** argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!strncmp(argv[i], "--export=", 9))
+            return true;
+    }
+    return false;
+}
 
 int main(int argc, char ** argv)
 {
+    // --export=PATTERN renders a run to images instead of opening a window,
+    // on the offscreen platform unless QT_QPA_PLATFORM picks another one
+    if (wantsExport(argc, argv)) {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        QGuiApplication app(argc, argv);
+        rng.seed(QTime::currentTime().msecsSinceStartOfDay());
+        return exportMain(app.arguments());
+    }
+
     QApplication app(argc, argv);
+    QStringList args = app.arguments();
+    rng.seed(QTime::currentTime().msecsSinceStartOfDay());
+
+    // --dashboard[=N] shows N machines side by side instead of the single machine view
+    int dashboard = 0;
+    if (args.contains("--dashboard"))
+        dashboard = 64;
+    dashboard = option(args, "dashboard", QString::number(dashboard)).toInt();
+
+    // --measure=S prints the dashboard's frame rate every second and quits after S seconds
+    int measure = option(args, "measure", "0").toInt();
+
     QMainWindow window;
-    MainWidget * widget = new MainWidget(&window);
-    window.setCentralWidget(widget);
+    if (dashboard > 0) {
+        DashboardWidget * widget = new DashboardWidget(dashboard, &window);
+        widget->setPrintFrameRate(measure > 0);
+        window.setCentralWidget(widget);
+        if (measure > 0)
+            QTimer::singleShot(measure * 1000, &app, SLOT(quit()));
+    }
+    else {
+        window.setCentralWidget(new MainWidget(&window));
+    }
     window.show();
     return app.exec();
 }
-
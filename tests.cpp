@@ -0,0 +1,240 @@
+#include "Explorer.hpp"
+#include "Machine.hpp"
+#include "PagedTape.hpp"
+#include "RunTape.hpp"
+#include <cstdio>
+#include <set>
+
+static int failures = 0;
+
+static void check(bool ok, std::string const & what)
+{
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n", what.c_str());
+        ++failures;
+    }
+}
+
+// Every workload kind, and a few parameters at their extremes
+static std::vector<std::string> workloadSpecs()
+{
+    std::vector<std::string> specs = workloadNames();
+    for (char const * spec : { "nearlysorted:1", "nearlysorted:100000", "runs:1", "runs:7", "runs:36000",
+                               "duplicates:1", "duplicates:300", "duplicates:36000" }) {
+        specs.push_back(spec);
+    }
+    return specs;
+}
+
+static void testParseWorkload()
+{
+    Workload workload;
+    check(parseWorkload("runs:12", workload) && workload.kind == RUNS && workload.parameter == 12, "runs:12 parses");
+    check(workloadName(workload) == "runs:12", "runs:12 round-trips");
+    check(parseWorkload("duplicates", workload) && workload.kind == DUPLICATES && workload.parameter == 0, "duplicates parses");
+    check(workloadName(workload) == "duplicates", "duplicates round-trips");
+    for (char const * spec : { "runs:", "runs:0", "runs:-3", "runs:+3", "runs: 3", "runs:3x", "uniform:3",
+                               "duplicates:36001", "nearlysorted:99999999999", "sorted" }) {
+        check(!parseWorkload(spec, workload), std::string(spec) + " is rejected");
+    }
+}
+
+// Every workload must keep hues distinct, up to the longest tape a sorter takes
+static void testDistinctHues()
+{
+    for (std::string const & workloadName : workloadSpecs()) {
+        Workload workload;
+        parseWorkload(workloadName, workload);
+        for (int len : { 20, 200, 1000, maxDistinctHues }) {
+            rng.seed(len);
+            std::vector<QColor> tape(len);
+            fillWorkload(tape, workload);
+            // QColor keeps hue in hundredths of a degree
+            std::set<int> hues;
+            for (QColor const & color : tape) {
+                hues.insert(qRound(color.hslHueF() * maxDistinctHues));
+            }
+            check((int)hues.size() == len, workloadName + " repeats a hue at length " + std::to_string(len));
+        }
+    }
+}
+
+// The sorters must halt on every workload, at every length the GUI offers
+// and at the lengths the batch runner is usually given
+static void testSortersHalt()
+{
+    std::vector<int> lengths;
+    for (int len = 20; len <= 200; ++len) {
+        lengths.push_back(len);
+    }
+    lengths.push_back(1);
+    lengths.push_back(2);
+    lengths.push_back(1000);
+
+    for (std::string const & name : { std::string("insertionsort"), std::string("mergesort") }) {
+        for (std::string const & workloadName : workloadSpecs()) {
+            Workload workload;
+            parseWorkload(workloadName, workload);
+            for (int len : lengths) {
+                rng.seed(len);
+                std::unique_ptr<Machine> machine = createMachine(name, workload);
+                std::vector<QColor> tape(len);
+                machine->reset(tape);
+                int pos = 0;
+                StepResult result = machine->advanceN(tape, pos, 100LL * len * len + 1000);
+                check(result.halted, name + " on " + workloadName + " did not halt at length " + std::to_string(len));
+            }
+        }
+    }
+}
+
+static void testSieveHalts()
+{
+    for (int len = minimumLength("sieve"); len <= 200; ++len) {
+        std::unique_ptr<Machine> machine = createMachine("sieve");
+        std::vector<QColor> tape(len);
+        machine->reset(tape);
+        int pos = 0;
+        StepResult result = machine->advanceN(tape, pos, 100LL * len * len + 1000);
+        check(result.halted, "sieve did not halt at length " + std::to_string(len));
+    }
+}
+
+// Runs of every machine on a RunTape, stopped and restarted at random step
+// counts, must end exactly like the dense run
+static void testRunTapeMatchesDense()
+{
+    std::mt19937 chunkRng(1);
+    std::uniform_int_distribution<long long> chunk(1, 5000);
+    for (std::string const & name : machineNames()) {
+        for (int len : { 2, 3, 17, 40, 97, 200 }) {
+            std::string what = name + " at length " + std::to_string(len);
+            rng.seed(len);
+            std::unique_ptr<Machine> dense = createMachine(name);
+            std::vector<QColor> denseTape(len);
+            dense->reset(denseTape);
+            int densePos = 0;
+            long long denseSteps = 0;
+            while (!dense->halted()) {
+                denseSteps += dense->advanceN(denseTape, densePos, chunk(chunkRng)).steps;
+            }
+
+            rng.seed(len);
+            std::unique_ptr<Machine> runs = createMachine(name);
+            RunTape runTape;
+            runTape.assign(len, Qt::black);
+            runs->resetRuns(runTape);
+            int runsPos = 0;
+            long long runsSteps = 0;
+            while (!runs->halted() && runsSteps <= denseSteps) {
+                runsSteps += run(*runs, runTape, runsPos, chunk(chunkRng));
+            }
+
+            check(runsSteps == denseSteps, "run tape step count differs for " + what);
+            check(runsPos == densePos, "run tape head differs for " + what);
+            check(runTape.toVector() == denseTape, "run tape contents differ for " + what);
+        }
+    }
+}
+
+// Unperturbed forks of a paged run must end exactly where one dense run does,
+// including on tapes of several pages
+static void testForkMatchesDense()
+{
+    long long const maxSteps = 200000;
+    for (std::string const & name : machineNames()) {
+        for (int len : { 40, 200, 3 * PagedTape::pageSize + 5 }) {
+            std::string what = name + " at length " + std::to_string(len);
+            rng.seed(len);
+            std::unique_ptr<Machine> dense = createMachine(name);
+            std::vector<QColor> denseTape(len);
+            dense->reset(denseTape);
+            int densePos = 0;
+            long long denseSteps = run(*dense, denseTape, densePos, maxSteps);
+
+            rng.seed(len);
+            Branch trunk{ createMachine(name), PagedTape(), 0, 0 };
+            std::vector<QColor> cells(len);
+            trunk.machine->reset(cells);
+            trunk.tape.assign(cells);
+            trunk.steps = run(*trunk.machine, trunk.tape, trunk.pos, maxSteps / 3);
+            std::vector<Branch> branches;
+            for (int i = 0; i < 3; ++i) {
+                branches.push_back(trunk.fork());
+            }
+            runBranches(branches, maxSteps - trunk.steps);
+
+            for (Branch const & branch : branches) {
+                check(branch.steps == denseSteps, "fork step count differs for " + what);
+                check(branch.pos == densePos, "fork head differs for " + what);
+                check(branch.machine->halted() == dense->halted(), "fork halting differs for " + what);
+                check(branch.tape.toVector() == denseTape, "fork contents differ for " + what);
+            }
+        }
+    }
+}
+
+// A fork shares every page until it writes, and then copies only that page
+static void testForkCopiesOnWrite()
+{
+    int len = 3 * PagedTape::pageSize + 5;
+    std::vector<QColor> cells(len);
+    for (int i = 0; i < len; ++i) {
+        cells[i] = QColor::fromHslF(qreal(i % 360) / 360, .9, .5);
+    }
+    Branch trunk{ createMachine("sieve"), PagedTape(), 0, 0 };
+    trunk.tape.assign(cells);
+    check(trunk.tape.pageCount() == 4, "a tape of three pages and five cells takes four pages");
+    check(trunk.tape.privatePages() == 4, "an unforked tape owns its pages");
+
+    Branch fork = trunk.fork();
+    check(fork.tape.privatePages() == 0 && trunk.tape.privatePages() == 0, "a new fork shares every page");
+    fork.tape.set(PagedTape::pageSize + 1, fork.tape.get(PagedTape::pageSize + 1));
+    check(fork.tape.privatePages() == 0, "writing a cell's own colour copies nothing");
+    fork.tape.set(PagedTape::pageSize + 1, Qt::black);
+    fork.tape.set(PagedTape::pageSize + 2, Qt::black);
+    check(fork.tape.privatePages() == 1 && trunk.tape.privatePages() == 1, "writes to one page copy only that page");
+    check(fork.tape.get(PagedTape::pageSize + 1) == Qt::black, "the fork sees its write");
+    check(trunk.tape.toVector() == cells, "the trunk doesn't see the fork's writes");
+}
+
+// A breadth-first search whose levels spill to disk must find exactly what
+// one held in memory does
+static void testExplorerSpills()
+{
+    std::unique_ptr<NondeterministicMachine> machine = createMarkerSearch();
+    for (int len : { 41, 300 }) {
+        std::string what = "marker search at length " + std::to_string(len);
+        ExploreSettings inMemory = { false, size_t(256) << 20, size_t(16) << 20, 2 };
+        ExploreSettings spilling = inMemory;
+        spilling.frontierMemory = 64;
+        ExploreResult expected = Explorer(*machine, len, inMemory).explore();
+        ExploreResult result = Explorer(*machine, len, spilling).explore();
+        check(expected.spilled == 0, "in-memory search spilled for " + what);
+        check(result.spilled > 0, "search did not spill for " + what);
+        check(expected.accepted >= 0, "in-memory search found no marker for " + what);
+        check(result.configurations == expected.configurations, "spilling changes the configuration count for " + what);
+        check(result.duplicates == expected.duplicates, "spilling changes the duplicate count for " + what);
+        check(result.depth == expected.depth, "spilling changes the depth for " + what);
+        check(result.accepted == expected.accepted, "spilling changes the accepted configuration for " + what);
+        check(!result.budgetExceeded, "spilling search ran out of budget for " + what);
+    }
+}
+
+int main()
+{
+    testParseWorkload();
+    testDistinctHues();
+    testSortersHalt();
+    testSieveHalts();
+    testRunTapeMatchesDense();
+    testForkMatchesDense();
+    testForkCopiesOnWrite();
+    testExplorerSpills();
+    if (failures) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
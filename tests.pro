@@ -0,0 +1,15 @@
+# Headless checks: qmake tests.pro && make -f Makefile.tests && ./turingmachine-tests
+TEMPLATE = app
+TARGET = turingmachine-tests
+QT = core gui
+CONFIG += qt console
+CONFIG -= app_bundle
+MAKEFILE = Makefile.tests
+OBJECTS_DIR = .obj-tests
+
+include(common.pri)
+
+HEADERS += Explorer.hpp
+
+SOURCES += Explorer.cpp
+SOURCES += tests.cpp
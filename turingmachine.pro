@@ -1,21 +1,26 @@
 TEMPLATE = app
-QT += widgets
+QT += widgets concurrent
 CONFIG += qt
 #CONFIG += debug
-QMAKE_CXXFLAGS += -std=c++11 -stdlib=libc++
-QMAKE_LFLAGS += -stdlib=libc++
+
+include(common.pri)
 
 # Input
-HEADERS += Machine.hpp
+HEADERS += Dashboard.hpp
+HEADERS += DashboardWidget.hpp
+HEADERS += Exporter.hpp
+HEADERS += HeadRenderer.hpp
 HEADERS += MainWidget.hpp
 HEADERS += ResetDialog.hpp
+HEADERS += Simulation.hpp
 HEADERS += TuringMachine.hpp
 
-SOURCES += InsertionSort.cpp
+SOURCES += Dashboard.cpp
+SOURCES += DashboardWidget.cpp
+SOURCES += Exporter.cpp
+SOURCES += HeadRenderer.cpp
 SOURCES += main.cpp
 SOURCES += MainWidget.cpp
-SOURCES += MergeSort.cpp
 SOURCES += ResetDialog.cpp
-SOURCES += Sieve.cpp
+SOURCES += Simulation.cpp
 SOURCES += TuringMachine.cpp
-